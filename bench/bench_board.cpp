@@ -0,0 +1,396 @@
+// Headless game-simulation benchmark: plays many complete games per board
+// configuration with a bot policy and reports throughput, win rate and
+// per-game latency. With --no-guess it instead times generateNoGuess() from
+// a centre first click, its speculative attempts spread over a pool of
+// --threads workers, and reports the latency distribution. Build with
+// `make bench_board`.
+//
+//   ./bench_board [--games N] [--policy random|solver|probability]
+//                 [--board WxH:MINES]... [--threads N] [--seed S]
+//                 [--safe-opening] [--no-guess] [--json FILE]
+
+#include "Minesweeper/Board.h"
+#include "Minesweeper/HintService.h"
+#include "Minesweeper/NoGuess.h"
+#include "Minesweeper/ProbabilityEngine.h"
+#include "Minesweeper/Random.h"
+#include "Minesweeper/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+enum class Policy { Random, Solver, Probability };
+
+struct BoardSpec {
+  int width, height, mines;
+};
+
+struct Options {
+  long games = 0; // 0: 100000 games, or 200 boards with --no-guess
+  Policy policy = Policy::Solver;
+  std::vector<BoardSpec> boards;
+  unsigned threads = std::thread::hardware_concurrency();
+  uint64_t seed = 1;
+  bool safeOpening = false;
+  bool noGuess = false;
+  std::string jsonPath;
+};
+
+struct GameResult {
+  bool won;
+  int moves;
+  int cells;
+};
+
+struct Totals {
+  long games = 0;
+  long wins = 0;
+  long moves = 0;
+  long cells = 0;
+  std::vector<float> latencyUs;
+};
+
+struct NoGuessTotals {
+  long boards = 0;
+  long found = 0;
+  std::vector<float> latencyMs;
+};
+
+const char *policyName(Policy policy) {
+  switch (policy) {
+  case Policy::Random:
+    return "random";
+  case Policy::Solver:
+    return "solver";
+  case Policy::Probability:
+    return "probability";
+  }
+  return "?";
+}
+
+// Uniform hidden, unflagged cell: rejection sampling while the board is
+// mostly hidden, a scan once it is not.
+bool randomHiddenCell(const Board &board, Random &rng, int &x, int &y) {
+  for (int attempt = 0; attempt < 32; ++attempt) {
+    x = static_cast<int>(rng.below(board.width));
+    y = static_cast<int>(rng.below(board.height));
+    if (!board.isRevealed(x, y) && !board.isFlagged(x, y))
+      return true;
+  }
+  std::vector<int> hidden;
+  for (int cy = 0; cy < board.height; ++cy)
+    for (int cx = 0; cx < board.width; ++cx)
+      if (!board.isRevealed(cx, cy) && !board.isFlagged(cx, cy))
+        hidden.push_back(cy * board.width + cx);
+  if (hidden.empty())
+    return false;
+  const int pick = hidden[rng.below(hidden.size())];
+  x = pick % board.width;
+  y = pick / board.width;
+  return true;
+}
+
+class Player {
+public:
+  Player(const BoardSpec &spec, Policy policy, bool safeOpening)
+      : board(spec.width, spec.height, spec.mines, 0), hints(board),
+        probabilities(board), policy(policy) {
+    board.safeOpening = safeOpening;
+  }
+
+  GameResult play(uint64_t seed) {
+    board.reset(seed);
+    if (policy != Policy::Random)
+      hints.onReset();
+    Random rng(seed ^ 0x5bd1e995ull);
+    GameResult result{false, 0, 0};
+
+    int x = board.width / 2, y = board.height / 2;
+    while (true) {
+      const bool hitMine = board.reveal(x, y);
+      result.moves++;
+      result.cells += static_cast<int>(board.lastRevealCount());
+      if (hitMine)
+        return result;
+      if (board.checkWin()) {
+        result.won = true;
+        return result;
+      }
+      if (!nextMove(rng, x, y))
+        return result;
+    }
+  }
+
+private:
+  Board board;
+  HintService hints;
+  ProbabilityEngine probabilities;
+  Policy policy;
+
+  bool nextMove(Random &rng, int &x, int &y) {
+    if (policy == Policy::Random)
+      return randomHiddenCell(board, rng, x, y);
+
+    hints.onReveal();
+    if (hints.nextSafe(x, y))
+      return true;
+    if (policy == Policy::Probability) {
+      probabilities.compute(std::chrono::milliseconds(2));
+      return probabilities.safestCell(x, y);
+    }
+    return randomHiddenCell(board, rng, x, y);
+  }
+};
+
+uint64_t gameSeed(uint64_t base, long game) {
+  uint64_t state = base + static_cast<uint64_t>(game);
+  return Random::splitmix64(state);
+}
+
+float percentile(const std::vector<float> &sorted, double p) {
+  if (sorted.empty())
+    return 0.0f;
+  const size_t i = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+  return sorted[std::min(i, sorted.size() - 1)];
+}
+
+bool parseBoard(const char *text, BoardSpec &spec) {
+  return std::sscanf(text, "%dx%d:%d", &spec.width, &spec.height,
+                     &spec.mines) == 3 &&
+         spec.width > 0 && spec.height > 0 && spec.mines >= 0 &&
+         spec.mines < spec.width * spec.height;
+}
+
+bool parseArgs(int argc, char **argv, Options &opts) {
+  for (int i = 1; i < argc; ++i) {
+    const char *arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if (!std::strcmp(arg, "--games") && hasValue) {
+      opts.games = std::atol(argv[++i]);
+    } else if (!std::strcmp(arg, "--policy") && hasValue) {
+      const char *name = argv[++i];
+      if (!std::strcmp(name, "random"))
+        opts.policy = Policy::Random;
+      else if (!std::strcmp(name, "solver"))
+        opts.policy = Policy::Solver;
+      else if (!std::strcmp(name, "probability"))
+        opts.policy = Policy::Probability;
+      else
+        return false;
+    } else if (!std::strcmp(arg, "--board") && hasValue) {
+      BoardSpec spec;
+      if (!parseBoard(argv[++i], spec))
+        return false;
+      opts.boards.push_back(spec);
+    } else if (!std::strcmp(arg, "--threads") && hasValue) {
+      opts.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+    } else if (!std::strcmp(arg, "--seed") && hasValue) {
+      opts.seed = std::strtoull(argv[++i], nullptr, 10);
+    } else if (!std::strcmp(arg, "--safe-opening")) {
+      opts.safeOpening = true;
+    } else if (!std::strcmp(arg, "--no-guess")) {
+      opts.noGuess = true;
+    } else if (!std::strcmp(arg, "--json") && hasValue) {
+      opts.jsonPath = argv[++i];
+    } else {
+      return false;
+    }
+  }
+  if (opts.boards.empty())
+    opts.boards = {{9, 9, 10}, {16, 16, 40}, {30, 16, 99}};
+  opts.threads = std::max(opts.threads, 1u);
+  if (opts.games == 0)
+    opts.games = opts.noGuess ? 200 : 100000;
+  return opts.games > 0;
+}
+
+bool writeJson(const Options &opts, const std::string &json) {
+  if (opts.jsonPath.empty())
+    return true;
+  FILE *out = opts.jsonPath == "-" ? stdout
+                                   : std::fopen(opts.jsonPath.c_str(), "w");
+  if (!out) {
+    std::perror(opts.jsonPath.c_str());
+    return false;
+  }
+  std::fputs(json.c_str(), out);
+  if (out != stdout)
+    std::fclose(out);
+  return true;
+}
+
+Totals runBoard(const Options &opts, const BoardSpec &spec, ThreadPool &pool,
+                double &seconds) {
+  constexpr long kBatch = 256;
+  std::atomic<long> next{0};
+  std::vector<Totals> perThread(opts.threads);
+
+  const Clock::time_point start = Clock::now();
+  pool.parallelFor(opts.threads, [&](size_t slot) {
+    Player player(spec, opts.policy, opts.safeOpening);
+    Totals &totals = perThread[slot];
+    long first;
+    while ((first = next.fetch_add(kBatch)) < opts.games) {
+      const long last = std::min(first + kBatch, opts.games);
+      for (long game = first; game < last; ++game) {
+        const Clock::time_point t0 = Clock::now();
+        const GameResult result = player.play(gameSeed(opts.seed, game));
+        const Clock::time_point t1 = Clock::now();
+        totals.games++;
+        totals.wins += result.won;
+        totals.moves += result.moves;
+        totals.cells += result.cells;
+        totals.latencyUs.push_back(
+            std::chrono::duration<float, std::micro>(t1 - t0).count());
+      }
+    }
+  });
+  seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+  Totals merged;
+  for (Totals &totals : perThread) {
+    merged.games += totals.games;
+    merged.wins += totals.wins;
+    merged.moves += totals.moves;
+    merged.cells += totals.cells;
+    merged.latencyUs.insert(merged.latencyUs.end(), totals.latencyUs.begin(),
+                            totals.latencyUs.end());
+  }
+  std::sort(merged.latencyUs.begin(), merged.latencyUs.end());
+  return merged;
+}
+
+// Boards are generated one after another, each using the whole pool, as
+// the game does on its first click.
+NoGuessTotals runNoGuess(const Options &opts, const BoardSpec &spec,
+                         ThreadPool &pool, double &seconds) {
+  NoGuessTotals totals;
+  const Clock::time_point start = Clock::now();
+  for (long game = 0; game < opts.games; ++game) {
+    Board board(spec.width, spec.height, spec.mines,
+                gameSeed(opts.seed, game));
+    const Clock::time_point t0 = Clock::now();
+    const bool found = generateNoGuess(board, spec.width / 2, spec.height / 2,
+                                       20000, pool);
+    const Clock::time_point t1 = Clock::now();
+    totals.boards++;
+    totals.found += found;
+    totals.latencyMs.push_back(
+        std::chrono::duration<float, std::milli>(t1 - t0).count());
+  }
+  seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  std::sort(totals.latencyMs.begin(), totals.latencyMs.end());
+  return totals;
+}
+
+int runNoGuessBoards(const Options &opts, ThreadPool &pool) {
+  std::string json = "{\n  \"mode\": \"no-guess\",\n  \"threads\": " +
+                     std::to_string(opts.threads) +
+                     ",\n  \"seed\": " + std::to_string(opts.seed) +
+                     ",\n  \"results\": [\n";
+
+  std::printf("%-12s %6s %8s %8s %9s %9s %9s %9s\n", "board", "mines",
+              "boards", "found%", "p50 ms", "p90 ms", "p99 ms", "max ms");
+  for (size_t b = 0; b < opts.boards.size(); ++b) {
+    const BoardSpec &spec = opts.boards[b];
+    double seconds = 0.0;
+    const NoGuessTotals totals = runNoGuess(opts, spec, pool, seconds);
+    const double found = double(totals.found) / totals.boards;
+    const float p50 = percentile(totals.latencyMs, 0.50);
+    const float p90 = percentile(totals.latencyMs, 0.90);
+    const float p99 = percentile(totals.latencyMs, 0.99);
+    const float max = totals.latencyMs.back();
+
+    const std::string size =
+        std::to_string(spec.width) + "x" + std::to_string(spec.height);
+    std::printf("%-12s %6d %8ld %7.2f%% %9.2f %9.2f %9.2f %9.2f\n",
+                size.c_str(), spec.mines, totals.boards, found * 100.0, p50,
+                p90, p99, max);
+
+    char entry[512];
+    std::snprintf(entry, sizeof(entry),
+                  "    {\"width\": %d, \"height\": %d, \"mines\": %d, "
+                  "\"boards\": %ld, \"seconds\": %.4f, "
+                  "\"found_rate\": %.5f, \"latency_ms\": {\"p50\": %.3f, "
+                  "\"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}}%s\n",
+                  spec.width, spec.height, spec.mines, totals.boards, seconds,
+                  found, p50, p90, p99, max,
+                  b + 1 < opts.boards.size() ? "," : "");
+    json += entry;
+  }
+  json += "  ]\n}\n";
+  return writeJson(opts, json) ? 0 : 1;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  Options opts;
+  if (!parseArgs(argc, argv, opts)) {
+    std::fprintf(stderr,
+                 "usage: %s [--games N] [--policy random|solver|probability] "
+                 "[--board WxH:MINES]... [--threads N] [--seed S] "
+                 "[--safe-opening] [--no-guess] [--json FILE]\n",
+                 argv[0]);
+    return 1;
+  }
+
+  ThreadPool pool(opts.threads);
+  if (opts.noGuess)
+    return runNoGuessBoards(opts, pool);
+
+  std::string json = "{\n  \"policy\": \"" +
+                     std::string(policyName(opts.policy)) +
+                     "\",\n  \"threads\": " + std::to_string(opts.threads) +
+                     ",\n  \"seed\": " + std::to_string(opts.seed) +
+                     ",\n  \"results\": [\n";
+
+  std::printf("%-12s %6s %10s %12s %12s %8s %9s %9s %9s\n", "board", "mines",
+              "games", "games/s", "reveals/s", "win%", "p50 us", "p99 us",
+              "max us");
+  for (size_t b = 0; b < opts.boards.size(); ++b) {
+    const BoardSpec &spec = opts.boards[b];
+    double seconds = 0.0;
+    const Totals totals = runBoard(opts, spec, pool, seconds);
+
+    const double gamesPerSec = totals.games / seconds;
+    const double revealsPerSec = totals.moves / seconds;
+    const double cellsPerSec = totals.cells / seconds;
+    const double winRate = double(totals.wins) / totals.games;
+    const double density = double(spec.mines) / (spec.width * spec.height);
+    const float p50 = percentile(totals.latencyUs, 0.50);
+    const float p90 = percentile(totals.latencyUs, 0.90);
+    const float p99 = percentile(totals.latencyUs, 0.99);
+    const float max = totals.latencyUs.back();
+
+    const std::string size =
+        std::to_string(spec.width) + "x" + std::to_string(spec.height);
+    std::printf("%-12s %6d %10ld %12.0f %12.0f %7.2f%% %9.1f %9.1f %9.1f\n",
+                size.c_str(), spec.mines, totals.games, gamesPerSec,
+                revealsPerSec, winRate * 100.0, p50, p99, max);
+
+    char entry[640];
+    std::snprintf(entry, sizeof(entry),
+                  "    {\"width\": %d, \"height\": %d, \"mines\": %d, "
+                  "\"density\": %.4f, \"games\": %ld, \"seconds\": %.4f, "
+                  "\"games_per_sec\": %.1f, \"reveals_per_sec\": %.1f, "
+                  "\"cells_per_sec\": %.1f, \"win_rate\": %.5f, "
+                  "\"latency_us\": {\"p50\": %.2f, \"p90\": %.2f, "
+                  "\"p99\": %.2f, \"max\": %.2f}}%s\n",
+                  spec.width, spec.height, spec.mines, density, totals.games,
+                  seconds, gamesPerSec, revealsPerSec, cellsPerSec, winRate,
+                  p50, p90, p99, max,
+                  b + 1 < opts.boards.size() ? "," : "");
+    json += entry;
+  }
+  json += "  ]\n}\n";
+  return writeJson(opts, json) ? 0 : 1;
+}
@@ -0,0 +1,310 @@
+// Microbenchmarks for Board hot paths, swept over board size and mine
+// density. Each case is warmed up, repeated, and summarized by its median
+// time normalized per cell (or per call). Results can be saved as a
+// baseline and later runs compared against it. Build with
+// `make bench_micro`.
+//
+//   ./bench_micro [--quick] [--filter NAME] [--reps N] [--warmup N]
+//                 [--save FILE] [--baseline FILE] [--threshold FRACTION]
+
+#include "Minesweeper/Board.h"
+#include "Minesweeper/Picking.h"
+#include "Minesweeper/Random.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC 1
+#endif
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+  bool quick = false;
+  std::string filter;
+  int reps = 0; // 0: scale with board size
+  int warmup = 1;
+  std::string savePath;
+  std::string baselinePath;
+  double threshold = 0.10;
+};
+
+struct Sample {
+  double ns;
+  double cycles;
+};
+
+struct Stats {
+  int reps = 0;
+  double medianNs = 0, meanNs = 0, minNs = 0, stddevNs = 0;
+  double medianCycles = 0;
+};
+
+// One timed unit of work. setup() runs outside the timer before every
+// repetition; run() is measured and returns the number of units it
+// processed (cells or calls) for normalization.
+struct Case {
+  const char *name;
+  const char *unit;
+  std::function<void(Board &, int)> setup;
+  std::function<double(Board &, int)> run;
+};
+
+uint64_t readCycles() {
+#ifdef BENCH_HAVE_TSC
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+volatile int sink;
+
+std::vector<Case> makeCases() {
+  std::vector<Case> cases;
+
+  cases.push_back({"reset", "cell", [](Board &, int) {},
+                   [](Board &board, int rep) {
+                     board.reset(1000 + rep);
+                     return double(board.width) * board.height;
+                   }});
+
+  cases.push_back({"calculateNumbers", "cell", [](Board &, int) {},
+                   [](Board &board, int) {
+                     board.calculateNumbers();
+                     return double(board.width) * board.height;
+                   }});
+
+  // First click from the middle: mine relocation plus the flood fill.
+  cases.push_back({"reveal", "cell",
+                   [](Board &board, int rep) {
+                     board.safeOpening = false;
+                     board.reset(2000 + rep);
+                   },
+                   [](Board &board, int) {
+                     board.reveal(board.width / 2, board.height / 2);
+                     return double(std::max<size_t>(board.lastRevealCount(),
+                                                    1));
+                   }});
+
+  // relocateMine is private; a safe-opening first click on a fresh layout
+  // moves every mine out of the 3x3 around the click.
+  cases.push_back({"relocateMine", "call",
+                   [](Board &board, int rep) {
+                     board.safeOpening = true;
+                     board.reset(3000 + rep);
+                     // the flood fill would dominate on sparse boards; a
+                     // ring of flags keeps it inside the 3x3 opening
+                     const int cx = board.width / 2, cy = board.height / 2;
+                     for (int y = cy - 2; y <= cy + 2; ++y)
+                       for (int x = cx - 2; x <= cx + 2; ++x)
+                         if (std::abs(x - cx) == 2 || std::abs(y - cy) == 2)
+                           board.toggleFlag(x, y);
+                   },
+                   [](Board &board, int) {
+                     board.reveal(board.width / 2, board.height / 2);
+                     return 1.0;
+                   }});
+
+  // The game-over check after a redo or load: a scan of the mine and
+  // revealed planes that finds nothing on a board still in play.
+  cases.push_back({"mineRevealed", "cell", [](Board &, int) {},
+                   [](Board &board, int) {
+                     sink = board.mineRevealed();
+                     return double(board.width) * board.height;
+                   }});
+
+  cases.push_back({"pickTile", "cell", [](Board &, int) {},
+                   [](Board &board, int rep) {
+                     Random rng(rep);
+                     const int tx = static_cast<int>(rng.below(board.width));
+                     const int ty = static_cast<int>(rng.below(board.height));
+                     const glm::vec3 origin(0.0f, 0.0f, 15.0f);
+                     const glm::vec3 dir =
+                         glm::normalize(gridCenter(tx, ty, board) - origin);
+                     int x = -1, y = -1;
+                     pickTile(board, origin, dir, 100.0f, x, y);
+                     sink = x + y;
+                     return double(board.width) * board.height;
+                   }});
+  return cases;
+}
+
+Stats summarize(std::vector<Sample> samples) {
+  Stats stats;
+  stats.reps = static_cast<int>(samples.size());
+  std::sort(samples.begin(), samples.end(),
+            [](const Sample &a, const Sample &b) { return a.ns < b.ns; });
+  const size_t mid = samples.size() / 2;
+  stats.medianNs = samples.size() % 2
+                       ? samples[mid].ns
+                       : 0.5 * (samples[mid - 1].ns + samples[mid].ns);
+  stats.medianCycles = samples[mid].cycles;
+  stats.minNs = samples.front().ns;
+  for (const Sample &s : samples)
+    stats.meanNs += s.ns;
+  stats.meanNs /= samples.size();
+  for (const Sample &s : samples)
+    stats.stddevNs += (s.ns - stats.meanNs) * (s.ns - stats.meanNs);
+  stats.stddevNs = std::sqrt(stats.stddevNs / samples.size());
+  return stats;
+}
+
+Stats measure(const Case &c, Board &board, int reps, int warmup) {
+  std::vector<Sample> samples;
+  for (int rep = 0; rep < warmup + reps; ++rep) {
+    c.setup(board, rep);
+    const uint64_t c0 = readCycles();
+    const Clock::time_point t0 = Clock::now();
+    const double units = c.run(board, rep);
+    const Clock::time_point t1 = Clock::now();
+    const uint64_t c1 = readCycles();
+    if (rep < warmup)
+      continue;
+    const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    samples.push_back({ns / units, double(c1 - c0) / units});
+  }
+  return summarize(samples);
+}
+
+// Repetitions shrink with board size so the big boards stay affordable.
+int repsFor(int cells, const Options &opts) {
+  if (opts.reps > 0)
+    return opts.reps;
+  return std::min(51, std::max(5, (1 << 22) / std::max(cells, 1)));
+}
+
+std::string keyFor(const char *name, int size, double density) {
+  char key[96];
+  std::snprintf(key, sizeof(key), "%s %d %.2f", name, size, density);
+  return key;
+}
+
+std::map<std::string, double> loadBaseline(const std::string &path) {
+  std::map<std::string, double> baseline;
+  FILE *in = std::fopen(path.c_str(), "r");
+  if (!in) {
+    std::perror(path.c_str());
+    return baseline;
+  }
+  char name[64];
+  int size;
+  double density, ns;
+  while (std::fscanf(in, "%63s %d %lf %lf", name, &size, &density, &ns) == 4)
+    baseline[keyFor(name, size, density)] = ns;
+  std::fclose(in);
+  return baseline;
+}
+
+bool parseArgs(int argc, char **argv, Options &opts) {
+  for (int i = 1; i < argc; ++i) {
+    const char *arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if (!std::strcmp(arg, "--quick"))
+      opts.quick = true;
+    else if (!std::strcmp(arg, "--filter") && hasValue)
+      opts.filter = argv[++i];
+    else if (!std::strcmp(arg, "--reps") && hasValue)
+      opts.reps = std::atoi(argv[++i]);
+    else if (!std::strcmp(arg, "--warmup") && hasValue)
+      opts.warmup = std::atoi(argv[++i]);
+    else if (!std::strcmp(arg, "--save") && hasValue)
+      opts.savePath = argv[++i];
+    else if (!std::strcmp(arg, "--baseline") && hasValue)
+      opts.baselinePath = argv[++i];
+    else if (!std::strcmp(arg, "--threshold") && hasValue)
+      opts.threshold = std::atof(argv[++i]);
+    else
+      return false;
+  }
+  return opts.warmup >= 0 && opts.reps >= 0;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  Options opts;
+  if (!parseArgs(argc, argv, opts)) {
+    std::fprintf(stderr,
+                 "usage: %s [--quick] [--filter NAME] [--reps N] "
+                 "[--warmup N] [--save FILE] [--baseline FILE] "
+                 "[--threshold FRACTION]\n",
+                 argv[0]);
+    return 1;
+  }
+
+  std::vector<int> sizes = {9, 16, 32, 64, 256, 1024, 2048, 4096, 8192};
+  if (opts.quick)
+    sizes = {9, 64, 256, 1024};
+  const std::vector<double> densities = {0.05, 0.10, 0.20, 0.35, 0.50};
+  const std::vector<Case> cases = makeCases();
+
+  std::map<std::string, double> baseline;
+  if (!opts.baselinePath.empty())
+    baseline = loadBaseline(opts.baselinePath);
+  FILE *save = nullptr;
+  if (!opts.savePath.empty() &&
+      !(save = std::fopen(opts.savePath.c_str(), "w"))) {
+    std::perror(opts.savePath.c_str());
+    return 1;
+  }
+
+  std::printf("%-17s %6s %7s %5s %12s %10s %10s %8s %s\n", "case", "size",
+              "density", "reps", "median ns", "", "cyc/unit", "stddev",
+              "vs baseline");
+  int regressions = 0;
+  for (int size : sizes) {
+    for (double density : densities) {
+      const int cells = size * size;
+      const int mines = std::max(1, static_cast<int>(cells * density));
+      Board board(size, size, mines, 1);
+      for (const Case &c : cases) {
+        if (!opts.filter.empty() && opts.filter != c.name)
+          continue;
+        const Stats stats =
+            measure(c, board, repsFor(cells, opts), opts.warmup);
+
+        std::string verdict;
+        const std::string key = keyFor(c.name, size, density);
+        auto it = baseline.find(key);
+        if (it != baseline.end() && it->second > 0.0) {
+          const double change = stats.medianNs / it->second - 1.0;
+          char text[48];
+          std::snprintf(text, sizeof(text), "%+6.1f%%%s", change * 100.0,
+                        change > opts.threshold ? "  SLOWER" : "");
+          verdict = text;
+          regressions += change > opts.threshold;
+        }
+
+        char perUnit[16];
+        std::snprintf(perUnit, sizeof(perUnit), "ns/%s", c.unit);
+        std::printf("%-17s %6d %6.0f%% %5d %12.3f %-10s %10.2f %7.1f%% %s\n",
+                    c.name, size, density * 100.0, stats.reps, stats.medianNs,
+                    perUnit, stats.medianCycles,
+                    100.0 * stats.stddevNs / stats.meanNs, verdict.c_str());
+        if (save)
+          std::fprintf(save, "%s %d %.2f %.6f\n", c.name, size, density,
+                       stats.medianNs);
+      }
+    }
+  }
+
+  if (save)
+    std::fclose(save);
+  if (regressions) {
+    std::printf("%d case(s) slower than baseline by more than %.0f%%\n",
+                regressions, opts.threshold * 100.0);
+    return 2;
+  }
+  return 0;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Helpers for packed bit-planes stored as arrays of 64-bit words.
+
+inline bool testBit(const uint64_t *words, size_t bit) {
+  return (words[bit >> 6] >> (bit & 63)) & 1u;
+}
+
+inline void setBit(uint64_t *words, size_t bit) {
+  words[bit >> 6] |= uint64_t(1) << (bit & 63);
+}
+
+inline void clearBit(uint64_t *words, size_t bit) {
+  words[bit >> 6] &= ~(uint64_t(1) << (bit & 63));
+}
+
+inline void flipBit(uint64_t *words, size_t bit) {
+  words[bit >> 6] ^= uint64_t(1) << (bit & 63);
+}
+
+inline int popcount64(uint64_t v) { return __builtin_popcountll(v); }
+
+inline int countTrailingZeros64(uint64_t v) { return __builtin_ctzll(v); }
+
+// Valid bits of the last word of a row `width` cells wide; rows are padded
+// out to whole words and the padding must stay clear.
+inline uint64_t rowTailMask(int width) {
+  return (width % 64) ? (uint64_t(1) << (width % 64)) - 1 : ~uint64_t(0);
+}
+
+// Sets or clears bits [begin, end), a whole word at a time.
+inline void fillBitRange(uint64_t *words, size_t begin, size_t end,
+                         bool value) {
+  while (begin < end) {
+    const size_t word = begin >> 6;
+    const size_t hi = end - (word << 6);
+    uint64_t mask = ~uint64_t(0) << (begin & 63);
+    if (hi < 64)
+      mask &= (uint64_t(1) << hi) - 1;
+    if (value)
+      words[word] |= mask;
+    else
+      words[word] &= ~mask;
+    begin = (word + 1) << 6;
+  }
+}
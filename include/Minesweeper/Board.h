@@ -1,25 +1,235 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include "Cell.h"
+#include "MoveJournal.h"
+#include "PlaneStorage.h"
+#include "Random.h"
 
 class Board {
 public:
+  // Cells are stored as packed bit-planes, one bit per cell. Each row is
+  // padded to a whole number of 64-bit words so rows never share a word.
+  // Neighbor counts are bit-sliced: bit k of a cell's count lives in
+  // CountPlane0 + k.
+  enum Plane {
+    MinePlane,
+    RevealedPlane,
+    FlaggedPlane,
+    CountPlane0,
+    CountPlane1,
+    CountPlane2,
+    CountPlane3,
+    PlaneCount
+  };
+
   int width, height, mineCount;
-  std::vector<Cell> cells;
+  // When set, the first reveal also clears every mine in the 3x3 around it.
+  bool safeOpening = false;
 
+  // A board is fully determined by its dimensions, mine count and seed; the
+  // seedless constructor picks a seed from the clock.
   Board(int w, int h, int mines);
+  Board(int w, int h, int mines, uint64_t seed);
 
+  // reset() starts a new layout with a seed drawn from the board's own
+  // generator; reset(seed) regenerates a specific layout.
   void reset();
+  void reset(uint64_t seed);
+  uint64_t seed() const { return boardSeed; }
+  bool isFirstMove() const { return firstMove; }
   bool reveal(int x, int y);
   void toggleFlag(int x, int y);
-  Cell &get(int x, int y);
-  const Cell &get(int x, int y) const;
+  // Reveals every hidden, unflagged neighbor of a revealed number whose
+  // flags already account for it, flood-filling from each as reveal()
+  // would; one undo step. Returns true when a mine was uncovered.
+  bool chord(int x, int y);
+  Cell get(int x, int y) const;
+
+  struct Move {
+    enum Kind : uint8_t { Reveal, Flag, Chord };
+    Kind kind;
+    int x, y;
+  };
+
+  struct MoveResult {
+    bool hitMine = false;
+    size_t movesApplied = 0;
+    size_t cellsRevealed = 0;
+    // bit indices of every cell revealed or flagged/unflagged, in order
+    std::vector<uint32_t> changed;
+  };
+
+  // Applies moves in order, stopping after one that uncovers a mine. The
+  // batch is journaled as one record and one undo step, and reaches the
+  // change stream as one append (after the cells around any mines the first
+  // reveal moved). The result is reused across calls.
+  void apply(const Move *moves, size_t count, MoveResult &result);
+  void apply(const std::vector<Move> &moves, MoveResult &result) {
+    apply(moves.data(), moves.size(), result);
+  }
+
+  bool isMine(int x, int y) const;
+  bool isRevealed(int x, int y) const;
+  bool isFlagged(int x, int y) const;
+  int neighborCount(int x, int y) const;
 
-  void calculateNumbers(); // add this declaration
-  bool checkWin();         // add this declaration
+  // Cells uncovered by the most recent reveal() or chord(), as bit indices.
+  size_t lastRevealCount() const { return revealQueue.size(); }
+  const std::vector<uint32_t> &lastRevealed() const { return revealQueue; }
+
+  // Live counters, kept up to date by every mutating call.
+  int hiddenSafeCount() const { return hiddenSafe; }
+  int flagCount() const { return flagsPlaced; }
+  int minesRemaining() const { return minesPlaced - flagsPlaced; }
+
+  void calculateNumbers();
+  bool checkWin() const { return hiddenSafe == 0; }
   void revealAllMines();
 
+  // Every reveal, flag toggle and revealAllMines() is journaled as a delta.
+  // undo()/redo() cost time proportional to the cells the move changed;
+  // reset() clears the journal.
+  bool undo();
+  bool redo();
+  // Whether any mine is uncovered, i.e. the game was lost or is over.
+  bool mineRevealed() const;
+  bool canUndo() const { return journal.canUndo(); }
+  bool canRedo() const { return journal.canRedo(); }
+  void setJournalBudget(size_t bytes) { journal.setBudget(bytes); }
+  size_t journalBytes() const { return journal.bytesUsed(); }
+
+  // Snapshots hold the board's counters, generator state and planes, the
+  // planes laid out exactly as in memory behind a page-sized header.
+  // loadSnapshot() maps the planes copy-on-write instead of reading them,
+  // so it costs the same for any board size; it may change the board's
+  // dimensions and drops the undo journal. saveSnapshot() replaces the file
+  // by renaming a new one over it, so boards mapping the old one are safe.
+  bool saveSnapshot(const char *path) const;
+  bool loadSnapshot(const char *path);
+
+  // Change stream. Every operation appends the bit index of each cell whose
+  // Cell value it changed to a log addressed by generation; a consumer keeps
+  // the generation it last synced to and catches up with changesSince().
+  // The first reveal's mine relocation logs the 3x3 block around each
+  // moved mine. Operations touching most of the board (reset, loading,
+  // calculateNumbers) and a log grown past a fraction of the board restart
+  // the log instead, and consumers behind that point resync fully.
+  // Generations are unique across every Board in the process, so one
+  // synced against a board that was since replaced (assigned, moved into or
+  // loaded over) also forces a full resync.
+  uint64_t changeGeneration() const {
+    return changeLog.base + changeLog.bits.size();
+  }
+
+  // Calls f(bit) for every cell changed after generation `since`, possibly
+  // more than once per cell. Returns false without calling f when `since`
+  // predates the log, meaning every cell must be treated as changed.
+  template <typename F> bool changesSince(uint64_t since, F &&f) const {
+    if (since < changeLog.base || since > changeGeneration())
+      return false;
+    for (size_t i = since - changeLog.base; i < changeLog.bits.size(); ++i)
+      f(changeLog.bits[i]);
+    return true;
+  }
+
+  size_t wordsPerRow() const { return rowWords; }
+  size_t wordsPerPlane() const { return planeWords; }
+  const uint64_t *plane(Plane p) const {
+    return storage.data() + static_cast<size_t>(p) * planeWords;
+  }
+  size_t bitIndex(int x, int y) const {
+    return static_cast<size_t>(y) * rowWords * 64 + static_cast<size_t>(x);
+  }
+
 private:
+  size_t rowWords;
+  size_t planeWords;
+  PlaneStorage storage;
+  // Scratch work queue for flood-fill reveals; holds the bit index of every
+  // cell uncovered by the last reveal and keeps its capacity between calls.
+  std::vector<uint32_t> revealQueue;
+  Random rng;
+  uint64_t boardSeed = 0;
   bool firstMove = true;
-  void relocateMine(int safeX, int safeY);
+  int hiddenSafe = 0;
+  int flagsPlaced = 0;
+  int minesPlaced = 0;
+
+  enum JournalOp : uint8_t { RevealOp, FlagOp, RevealAllMinesOp };
+  // A RevealOp from apply() may also carry the flags its batch toggled.
+  enum RevealFlags : uint8_t {
+    HitMine = 1,
+    FirstReveal = 2,
+    FlagsToggled = 4
+  };
+  MoveJournal journal;
+  std::vector<uint8_t> journalRecord;
+  std::vector<uint32_t> journalCells;
+  MoveJournal::SpanWriter journalSpans[2];
+  // scratch plane marking the cells of the reveal being journaled, and the
+  // words of it that are marked
+  std::vector<uint64_t> journalMarks;
+  std::vector<uint32_t> journalWords;
+  // (from, to + 1) bit index pairs for mines moved by the first reveal; a
+  // zero target means the mine left the board
+  std::vector<uint32_t> relocations;
+  // scratch for apply(): every flag the batch toggled
+  std::vector<uint32_t> batchFlags;
+
+  // Each restart claims the generations [base, base + span) from a
+  // process-wide counter, span covering the longest log before the next
+  // restart. A copy claims a range of its own rather than sharing one with
+  // a board it will diverge from.
+  struct ChangeLog {
+    std::vector<uint32_t> bits;
+    uint64_t base = 0;
+    uint64_t span = 0;
+
+    ChangeLog() = default;
+    ChangeLog(const ChangeLog &other) { restart(other.span); }
+    ChangeLog &operator=(const ChangeLog &other) {
+      restart(other.span);
+      return *this;
+    }
+    ChangeLog(ChangeLog &&) = default;
+    ChangeLog &operator=(ChangeLog &&) = default;
+
+    void restart(uint64_t newSpan);
+  };
+  ChangeLog changeLog;
+
+  uint64_t *mutablePlane(Plane p) {
+    return storage.data() + static_cast<size_t>(p) * planeWords;
+  }
+  int countAt(size_t bit) const;
+  void setCountAt(size_t bit, int count);
+  void placeMines(int rowBegin, int rowEnd, int count, Random &bandRng);
+  void addMine(int x, int y);
+  void removeMine(int x, int y);
+  bool findRelocationTarget(int safeX, int safeY, int radius, int &outX,
+                            int &outY);
+  void relocateMine(int mineX, int mineY, int safeX, int safeY, int radius);
+
+  // Single moves without journaling or logging; the cells they uncover are
+  // left in revealQueue.
+  bool flipFlag(size_t bit);
+  bool revealCells(int x, int y);
+  int chordCells(int x, int y);
+  void floodFill();
+  size_t changeLogLimit() const;
+  void logChange(uint32_t bit);
+  void logChanges(const std::vector<uint32_t> &bits);
+  void logChangedRange(size_t begin, size_t end);
+  void logMovedMines(const std::vector<uint32_t> &cells);
+  void restartChangeLog();
+  // Revealed cells are marked as moves complete; recordReveal() journals
+  // every cell marked since the last record.
+  void markJournalCells(const std::vector<uint32_t> &cells);
+  void recordReveal(int minesHit, bool firstReveal,
+                    const std::vector<uint32_t> *flagsToggled = nullptr);
+  void replayReveal(MoveJournal::Reader &record, bool forward);
+  void replayRevealAllMines(MoveJournal::Reader &record, bool forward);
+  void moveMine(uint32_t from, uint32_t to);
 };
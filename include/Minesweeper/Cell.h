@@ -1,3 +1,5 @@
+#pragma once
+
 enum class CellType { Empty, Mine };
 enum class CellState { Hidden, Revealed, Flagged };
 
@@ -4,7 +4,11 @@ class Cube {
 public:
   Cube();
   ~Cube();
+  static constexpr int kVertexCount = 36;
+
   void Draw() const;
+  // positions and normals, six floats per vertex
+  unsigned int vertexBuffer() const { return VBO; }
 
 private:
   unsigned int VAO, VBO;
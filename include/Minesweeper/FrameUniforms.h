@@ -0,0 +1,37 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Values shared by every program each frame, in the std140 layout of the
+// `Frame` uniform block the shaders declare at binding 0.
+struct FrameData {
+  glm::mat4 projection;
+  glm::mat4 view;
+  glm::mat4 skyView;     // view without its translation
+  glm::mat4 skyRotation; // slow drift applied to skybox lookups
+  glm::vec4 cameraPos;   // xyz
+  float time;
+  float pad[3];
+};
+
+// Uniform buffer holding FrameData, bound to its binding point for the
+// lifetime of the object and rewritten once per frame.
+class FrameUniforms {
+public:
+  static constexpr GLuint kBinding = 0;
+
+  FrameUniforms();
+  ~FrameUniforms();
+
+  FrameUniforms(const FrameUniforms &) = delete;
+  FrameUniforms &operator=(const FrameUniforms &) = delete;
+
+  void update(const glm::mat4 &projection, const glm::mat4 &view,
+              const glm::vec3 &cameraPos, float time);
+
+private:
+  GLuint UBO = 0;
+};
+
+// Rotation the sky has drifted through by `time` seconds.
+glm::mat3 skyRotation(float time);
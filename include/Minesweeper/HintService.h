@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Board.h"
+#include "Solver.h"
+
+// Keeps Solver deductions for a Board up to date across moves. Reveals and
+// new flags re-propagate only the constraints around the cells they
+// changed; removing a flag or starting a new layout re-solves from scratch.
+// Proven cells are consumed through cursors, so nextSafe()/nextMine() are
+// amortized O(1) however large the board.
+class HintService {
+public:
+  explicit HintService(const Board &board);
+
+  // Call after the matching Board operation.
+  void onReveal() { changed(board.lastRevealed()); }
+  void onToggleFlag(int x, int y);
+  void onReset();
+
+  void changed(const std::vector<uint32_t> &cells);
+
+  // A hidden, unflagged cell proven safe (or a mine); false when the
+  // current deductions have none left.
+  bool nextSafe(int &outX, int &outY);
+  bool nextMine(int &outX, int &outY);
+
+  const Solver &solver() const { return deductions; }
+
+private:
+  const Board &board;
+  Solver deductions;
+  std::vector<uint32_t> single;
+  size_t safeCursor = 0;
+  size_t mineCursor = 0;
+
+  bool advance(const std::vector<uint32_t> &cells, size_t &cursor, int &outX,
+               int &outY) const;
+};
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Cell.h"
+
+// Unbounded board for endless sessions. Mines are never stored: a cell holds
+// a mine when a counter-based hash of (seed, x, y) falls below the density
+// threshold, so any cell can be queried in O(1) without generating the chunks
+// around it. The plane is split into 64x64 chunks that are materialized on
+// the first reveal or flag inside them; a chunk caches its mine and count
+// planes next to the player state. Chunks without player state can be
+// evicted at any time and are rebuilt from the hash when touched again.
+class InfiniteBoard {
+public:
+  static constexpr int ChunkSize = 64;
+
+  InfiniteBoard(double density, uint64_t seed);
+
+  bool reveal(int64_t x, int64_t y);
+  void toggleFlag(int64_t x, int64_t y);
+  Cell get(int64_t x, int64_t y) const;
+
+  bool isMine(int64_t x, int64_t y) const;
+  int neighborCount(int64_t x, int64_t y) const;
+
+  // Number of cells uncovered by the most recent reveal() call. A single
+  // reveal stops after revealLimit cells so low densities cannot run away.
+  size_t lastRevealCount() const { return revealQueue.size(); }
+  size_t revealLimit = size_t(1) << 22;
+
+  size_t revealedCount() const { return revealedCells; }
+  size_t flagCount() const { return flaggedCells; }
+  size_t chunkCount() const { return chunks.size(); }
+  uint64_t seed() const { return boardSeed; }
+
+  // Drops every materialized chunk that carries no revealed or flagged cell.
+  // Returns the number of chunks released.
+  size_t evictUntouched();
+
+private:
+  struct Chunk {
+    uint64_t mines[ChunkSize];
+    uint64_t counts[4][ChunkSize]; // bit-sliced like Board's count planes
+    uint64_t revealed[ChunkSize] = {};
+    uint64_t flagged[ChunkSize] = {};
+    int touched = 0; // revealed + flagged cells in this chunk
+  };
+
+  // Chunks are keyed by both full 64-bit coordinates, so chunks any
+  // distance apart never share an entry.
+  using ChunkKey = std::pair<int64_t, int64_t>;
+  struct ChunkKeyHash {
+    size_t operator()(const ChunkKey &key) const;
+  };
+
+  uint64_t boardSeed;
+  uint64_t threshold;
+  bool firstMove = true;
+  int64_t safeX = 0, safeY = 0;
+  size_t revealedCells = 0;
+  size_t flaggedCells = 0;
+  std::unordered_map<ChunkKey, Chunk, ChunkKeyHash> chunks;
+  std::vector<std::pair<int64_t, int64_t>> revealQueue;
+
+  static ChunkKey chunkKey(int64_t cx, int64_t cy) { return {cx, cy}; }
+  bool hashMine(int64_t x, int64_t y) const;
+  const Chunk *findChunk(int64_t x, int64_t y) const;
+  Chunk &touchChunk(int64_t x, int64_t y);
+  void buildChunk(Chunk &chunk, int64_t cx, int64_t cy) const;
+};
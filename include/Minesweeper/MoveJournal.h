@@ -0,0 +1,103 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Byte log of move records for undo/redo. Each record is framed by its
+// length at both ends (a varint before it and the same varint, bytes
+// reversed, after it) so the log can be walked in either direction. The
+// oldest records are dropped once the log outgrows its budget; the newest
+// record is always kept.
+class MoveJournal {
+public:
+  static constexpr size_t kDefaultBudget = 64 * 1024;
+
+  explicit MoveJournal(size_t budgetBytes = kDefaultBudget)
+      : budgetBytes(budgetBytes) {}
+
+  // Sequential reader over one record's payload.
+  struct Reader {
+    const uint8_t *pos = nullptr;
+    const uint8_t *end = nullptr;
+
+    uint8_t byte() { return *pos++; }
+    uint64_t varint() {
+      uint64_t value = 0;
+      for (int shift = 0;; shift += 7) {
+        const uint8_t b = *pos++;
+        value |= uint64_t(b & 0x7f) << shift;
+        if (!(b & 0x80))
+          return value;
+      }
+    }
+    // Calls f(begin, end) for every span written by putSpans().
+    template <typename F> size_t spans(F f) {
+      size_t total = 0, last = 0;
+      for (uint64_t runs = varint(); runs > 0; --runs) {
+        const size_t begin = last + varint();
+        last = begin + varint();
+        f(begin, last);
+        total += last - begin;
+      }
+      return total;
+    }
+  };
+
+  static void putVarint(std::vector<uint8_t> &out, uint64_t value) {
+    while (value >= 0x80) {
+      out.push_back(static_cast<uint8_t>(value) | 0x80);
+      value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+  }
+  // Bounds-checked counterpart of putVarint() for untrusted bytes: false
+  // when the varint runs past `end` or past 64 bits.
+  static bool getVarint(const uint8_t *&pos, const uint8_t *end,
+                        uint64_t &value) {
+    value = 0;
+    for (int shift = 0; pos < end && shift < 64; shift += 7) {
+      const uint8_t b = *pos++;
+      value |= uint64_t(b & 0x7f) << shift;
+      if (!(b & 0x80))
+        return true;
+    }
+    return false;
+  }
+
+  // Collects runs of set bits, fed in increasing order, and encodes them as
+  // (gap from the previous run's end, length) pairs after the run count.
+  class SpanWriter {
+  public:
+    void clear() { runs.clear(); }
+    void addRun(size_t begin, size_t end);
+    // The bits of mask, read as bit indices wordIndex * 64 + i.
+    void addWord(size_t wordIndex, uint64_t mask);
+    void write(std::vector<uint8_t> &out) const;
+
+  private:
+    std::vector<size_t> runs; // begin, end pairs
+  };
+
+  // Appends a record and discards anything that could have been redone.
+  void append(const std::vector<uint8_t> &payload);
+
+  bool canUndo() const { return cursor > head; }
+  bool canRedo() const { return cursor < data.size(); }
+  // Step the cursor over one record and return its payload.
+  Reader undo();
+  Reader redo();
+
+  void clear();
+  void setBudget(size_t bytes);
+  size_t budget() const { return budgetBytes; }
+  size_t bytesUsed() const { return data.size() - head; }
+  size_t capacityBytes() const { return data.capacity(); }
+
+private:
+  std::vector<uint8_t> data;
+  size_t head = 0;   // first live byte; older records were dropped
+  size_t cursor = 0; // records before it can be undone, after it redone
+  size_t budgetBytes;
+
+  void trim();
+};
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// 3x3 neighbor-count kernels over a row-padded mine plane (rowWords 64-bit
+// words per row, padding bits zero). Counts are written bit-sliced: bit k of
+// each cell's count goes to counts[k]. Mine cells and padding bits get 0.
+// Only rows [rowBegin, rowEnd) are written; rows outside that range are
+// still read as halo.
+
+void countNeighborsBitSliced(const uint64_t *mines, size_t rowWords, int width,
+                             int height, uint64_t *const counts[4],
+                             int rowBegin, int rowEnd);
+
+void countNeighborsScalar(const uint64_t *mines, size_t rowWords, int width,
+                          int height, uint64_t *const counts[4], int rowBegin,
+                          int rowEnd);
+
+// 26-neighbor variant for volumes. Rows run along x and are stored z-major
+// (row index z * height + y). Counts reach 26, so they are sliced over five
+// planes. Only slices [zBegin, zEnd) are written.
+void countNeighbors26BitSliced(const uint64_t *mines, size_t rowWords,
+                               int width, int height, int depth,
+                               uint64_t *const counts[5], int zBegin,
+                               int zEnd);
@@ -0,0 +1,16 @@
+#pragma once
+#include "Board.h"
+#include "ThreadPool.h"
+
+// Searches for a layout that Solver clears from the first click without a
+// single guess. Candidate seeds are derived from board.seed() and tried
+// concurrently on the pool; the lowest-numbered solvable candidate wins, so
+// the result does not depend on thread count, and attempts numbered above
+// the current winner are abandoned mid-solve.
+//
+// On success the board is reset to the winning seed with safeOpening set and
+// the caller should reveal (firstX, firstY) next. Returns false, leaving the
+// board untouched, when no candidate within maxAttempts is solvable.
+bool generateNoGuess(Board &board, int firstX, int firstY,
+                     int maxAttempts = 20000,
+                     ThreadPool &pool = ThreadPool::shared());
@@ -0,0 +1,15 @@
+#pragma once
+#include <glm/glm.hpp>
+#include "Board.h"
+
+// World-space layout of a Board's tiles: unit cubes on the z = 0 plane,
+// centered on the origin with a small gap between neighbors.
+constexpr float kTileSpacing = 1.05f;
+
+glm::vec3 gridCenter(int x, int y, const Board &board);
+
+// Ray-AABB test against every tile; returns the nearest tile the ray enters
+// closer than maxDistance.
+bool pickTile(const Board &board, const glm::vec3 &origin,
+              const glm::vec3 &direction, float maxDistance, int &outX,
+              int &outY);
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Backing words for a board's bit-planes: either an owned, zeroed buffer or
+// a private mapping of a file. Writes to a mapping land on copy-on-write
+// pages and never reach the file, so a mapped board plays like an owned
+// one. Copies are always owned.
+class PlaneStorage {
+public:
+  PlaneStorage() = default;
+  explicit PlaneStorage(size_t words) { assign(words); }
+  ~PlaneStorage() { unmap(); }
+  PlaneStorage(const PlaneStorage &other);
+  PlaneStorage(PlaneStorage &&other) noexcept { *this = std::move(other); }
+  PlaneStorage &operator=(const PlaneStorage &other);
+  PlaneStorage &operator=(PlaneStorage &&other) noexcept;
+
+  // Replaces the contents with `words` owned zero words.
+  void assign(size_t words);
+  // Maps `words` words starting `offset` bytes into the open file. Pages
+  // are read in on first touch.
+  bool map(int fd, size_t offset, size_t words);
+
+  uint64_t *data() { return words; }
+  const uint64_t *data() const { return words; }
+  size_t size() const { return count; }
+  bool isMapped() const { return mapBase != nullptr; }
+
+private:
+  std::vector<uint64_t> owned;
+  void *mapBase = nullptr;
+  size_t mapBytes = 0;
+  uint64_t *words = nullptr;
+  size_t count = 0;
+
+  void unmap();
+};
@@ -0,0 +1,87 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "Board.h"
+
+// Per-cell mine probabilities for a Board's visible state. Hidden cells next
+// to a revealed number form the frontier; cells linked through shared
+// constraints are grouped into independent components by a breadth-first
+// walk of the cell/constraint graph, which also fixes the enumeration order.
+// Each component's configurations are enumerated by backtracking and
+// tallied by mine count, and the components are combined with the remaining
+// mine count by weighting every total K with C(U, M - K), U being the
+// unconstrained hidden cells. Player flags are taken as mines, as in Solver.
+//
+// Enumerations are memoized by the component's constraint structure, so a
+// component that survives a move unchanged costs a hash lookup next time.
+class ProbabilityEngine {
+public:
+  explicit ProbabilityEngine(const Board &board);
+
+  // Recomputes every probability, evaluating components in parallel on the
+  // shared pool. Components still enumerating when the budget runs out fall
+  // back to a local estimate; returns false when any estimate was used.
+  bool compute(std::chrono::microseconds budget = std::chrono::milliseconds(8));
+
+  // Probability that (x, y) is a mine: 0 for revealed cells, 1 for flags.
+  float mineProbability(int x, int y) const {
+    return probs[static_cast<size_t>(y) * board.width + x];
+  }
+
+  // Whether the last compute() was exact for every cell.
+  bool exact() const { return exactResult; }
+  size_t componentCount() const { return components.size(); }
+
+  // Hidden unflagged cell least likely to be a mine.
+  bool safestCell(int &outX, int &outY) const;
+
+  // A cell touches at most eight constraints and a constraint at most eight
+  // cells, so adjacency lists live inline.
+  struct Links {
+    int count = 0;
+    int items[8];
+    void push(int v) { items[count++] = v; }
+    const int *begin() const { return items; }
+    const int *end() const { return items + count; }
+  };
+
+  struct Component {
+    std::vector<uint32_t> cells; // board bit indices, in enumeration order
+    std::vector<Links> cellConstraints;
+    std::vector<Links> constraintCells;
+    std::vector<int> needed;
+    std::vector<uint32_t> key; // structure only, independent of position
+  };
+
+  // Configuration counts by mine count k = fewestMines + r: solutions[r],
+  // and cellMines[r * cells + i] for those with cell i mined.
+  struct Distribution {
+    int fewestMines = 0;
+    std::vector<double> solutions;
+    std::vector<double> cellMines;
+  };
+
+private:
+  struct KeyHash {
+    size_t operator()(const std::vector<uint32_t> &key) const {
+      uint64_t h = 0x9e3779b97f4a7c15ull;
+      for (uint32_t v : key)
+        h = (h ^ v) * 0x100000001b3ull;
+      return static_cast<size_t>(h ^ (h >> 29));
+    }
+  };
+
+  const Board &board;
+  std::vector<float> probs;
+  std::vector<int> frontierId; // by bit index, -1 off the frontier
+  std::vector<Component> components;
+  std::unordered_map<std::vector<uint32_t>, Distribution, KeyHash> cache;
+  bool exactResult = true;
+
+  void buildComponents(int &unknownCells);
+  void combine(std::vector<Distribution> &dists, int unknownCells);
+  void fillUniform(float probability);
+};
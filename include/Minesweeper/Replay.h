@@ -0,0 +1,169 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Board.h"
+
+// Binary replay format, version 2. A file is any number of replays back to
+// back, each a 40-byte little-endian header followed by its events:
+//
+//   0  "MSRP"           magic
+//   4  u16 version      kReplayVersion
+//   6  u16 flags        bit 0: safe opening
+//   8  u32 width, u32 height, u32 mines
+//   20 u32 event count
+//   24 u64 seed         Board::reset(seed) reproduces the layout
+//   32 u64 event bytes
+//
+// Each event is varint(dt << 3 | op), dt being milliseconds since the
+// previous event, followed for cell operations by the zigzag varint delta
+// of the cell index (y * width + x) from the previous cell event. Version 2
+// added Chord; version 1 replays still read, as they never contain it.
+enum class ReplayOp : uint8_t {
+  Reveal,
+  Flag,
+  Undo,
+  Redo,
+  RevealAllMines,
+  Chord
+};
+
+constexpr uint16_t kReplayVersion = 2;
+constexpr size_t kReplayHeaderSize = 40;
+
+struct ReplayHeader {
+  uint16_t version = kReplayVersion;
+  uint16_t flags = 0;
+  int width = 0, height = 0, mines = 0;
+  uint32_t eventCount = 0;
+  uint64_t seed = 0;
+  uint64_t eventBytes = 0;
+
+  enum Flags : uint16_t { SafeOpening = 1 };
+};
+
+struct ReplayEvent {
+  uint64_t timeMs;
+  ReplayOp op;
+  int x, y;
+};
+
+// Records one game in memory.
+class ReplayWriter {
+public:
+  // Starts a new recording of the board's current layout; events before
+  // the first begin() are dropped.
+  void begin(const Board &board);
+
+  void reveal(uint64_t timeMs, int x, int y) {
+    add(timeMs, ReplayOp::Reveal, x, y);
+  }
+  void toggleFlag(uint64_t timeMs, int x, int y) {
+    add(timeMs, ReplayOp::Flag, x, y);
+  }
+  void chord(uint64_t timeMs, int x, int y) {
+    add(timeMs, ReplayOp::Chord, x, y);
+  }
+  void undo(uint64_t timeMs) { add(timeMs, ReplayOp::Undo, 0, 0); }
+  void redo(uint64_t timeMs) { add(timeMs, ReplayOp::Redo, 0, 0); }
+  void revealAllMines(uint64_t timeMs) {
+    add(timeMs, ReplayOp::RevealAllMines, 0, 0);
+  }
+
+  uint32_t eventCount() const { return header.eventCount; }
+
+  // Header plus events, ready to be appended to a replay file.
+  void encode(std::vector<uint8_t> &out) const;
+  bool appendTo(const char *path) const;
+
+private:
+  ReplayHeader header;
+  std::vector<uint8_t> events;
+  uint64_t lastTime = 0;
+  int64_t lastCell = 0;
+
+  void add(uint64_t timeMs, ReplayOp op, int x, int y);
+};
+
+// Decodes one replay's events straight out of the mapped bytes.
+class ReplayCursor {
+public:
+  ReplayCursor() = default;
+  ReplayCursor(const ReplayHeader &header, const uint8_t *begin,
+               const uint8_t *end)
+      : width(header.width),
+        cells(static_cast<int64_t>(header.width) * header.height),
+        lastOp(header.version >= 2 ? ReplayOp::Chord
+                                   : ReplayOp::RevealAllMines),
+        pos(begin), end(end) {}
+
+  // False at the end of the replay, on a truncated event or on one naming
+  // a cell off the board.
+  bool next(ReplayEvent &event);
+
+private:
+  int width = 1;
+  int64_t cells = 0;
+  ReplayOp lastOp = ReplayOp::Chord;
+  const uint8_t *pos = nullptr;
+  const uint8_t *end = nullptr;
+  uint64_t time = 0;
+  int64_t cell = 0;
+};
+
+struct ReplayView {
+  ReplayHeader header;
+  const uint8_t *begin = nullptr;
+  const uint8_t *end = nullptr;
+
+  ReplayCursor events() const { return ReplayCursor(header, begin, end); }
+};
+
+// Read-only memory map of a replay file; replays and their events are
+// decoded in place, nothing is copied.
+class ReplayArchive {
+public:
+  ReplayArchive() = default;
+  ~ReplayArchive() { close(); }
+  ReplayArchive(const ReplayArchive &) = delete;
+  ReplayArchive &operator=(const ReplayArchive &) = delete;
+
+  bool open(const char *path);
+  void close();
+
+  // Steps to the next replay; false at the end of the file or at a header
+  // that is malformed, describes a board Board cannot index, or runs past
+  // the file.
+  bool next(ReplayView &view);
+  void rewind() { offset = 0; }
+  size_t size() const { return length; }
+
+private:
+  const uint8_t *data = nullptr;
+  size_t length = 0;
+  size_t offset = 0;
+};
+
+// A board set up for playback of the replay.
+Board makeReplayBoard(const ReplayHeader &header);
+void applyReplayEvent(Board &board, const ReplayEvent &event);
+
+// Plays a replay against a board at whatever pace the caller drives it:
+// advance(t) applies every event stamped at or before t milliseconds, so
+// scaling t plays back at any speed.
+class ReplayPlayer {
+public:
+  ReplayPlayer(const ReplayView &view, Board &board)
+      : cursor(view.events()), board(board) {
+    pending = cursor.next(upcoming);
+  }
+
+  size_t advance(uint64_t timeMs);
+  bool finished() const { return !pending; }
+
+private:
+  ReplayCursor cursor;
+  Board &board;
+  ReplayEvent upcoming{};
+  bool pending = false;
+};
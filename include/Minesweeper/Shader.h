@@ -1,16 +1,73 @@
 #pragma once
 #include <string>
+#include <vector>
+#include <glad/glad.h>
 #include <glm/glm.hpp>
 
+// A uniform location resolved once; set() is a single glUniform call on the
+// program in use. Handles to uniforms the program does not have hold -1,
+// which GL ignores.
+template <typename T> class Uniform {
+public:
+  Uniform() = default;
+  explicit Uniform(GLint location) : location(location) {}
+
+  void set(const T &value) const;
+  bool valid() const { return location >= 0; }
+
+private:
+  GLint location = -1;
+};
+
+template <> inline void Uniform<bool>::set(const bool &value) const {
+  glUniform1i(location, value);
+}
+template <> inline void Uniform<int>::set(const int &value) const {
+  glUniform1i(location, value);
+}
+template <> inline void Uniform<float>::set(const float &value) const {
+  glUniform1f(location, value);
+}
+template <> inline void Uniform<glm::vec3>::set(const glm::vec3 &value) const {
+  glUniform3fv(location, 1, &value[0]);
+}
+template <> inline void Uniform<glm::mat4>::set(const glm::mat4 &value) const {
+  glUniformMatrix4fv(location, 1, GL_FALSE, &value[0][0]);
+}
+
 class Shader {
 public:
   unsigned int ID;
 
+  // Active uniforms reflected after linking, sorted by name. Arrays are
+  // listed under their bare name.
+  struct UniformInfo {
+    std::string name;
+    GLint location;
+    GLenum type;
+    GLint size;
+  };
+
   Shader(const char *vertexPath, const char *fragmentPath);
   void use() const;
+
+  // Location from the reflected table, -1 when the uniform is not active.
+  GLint uniformLocation(const std::string &name) const;
+  template <typename T> Uniform<T> uniform(const std::string &name) const {
+    return Uniform<T>(uniformLocation(name));
+  }
+  const std::vector<UniformInfo> &uniforms() const { return uniformTable; }
+
   void setBool(const std::string &name, bool value) const;
   void setInt(const std::string &name, int value) const;
   void setFloat(const std::string &name, float value) const;
   void setVec3(const std::string &name, const glm::vec3 &value) const;
+  void setVec3Array(const std::string &name, const glm::vec3 *values,
+                    int count) const;
   void setMat4(const std::string &name, const glm::mat4 &mat) const;
+
+private:
+  std::vector<UniformInfo> uniformTable;
+
+  void reflectUniforms();
 };
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Board.h"
+
+// Deterministic constraint-propagation solver over a Board's visible state.
+// Every revealed number is a constraint on its hidden neighbors; player flags
+// are taken as mines. Two rules run to a fixpoint from a worklist:
+//   - single cell: a constraint needing 0 mines, or as many mines as it has
+//     unknown cells, settles all of them;
+//   - subset: when one constraint's unknowns are a subset of another's, the
+//     difference must hold exactly the difference in mines.
+// All buffers are sized when the solver is built, so solve() never
+// allocates.
+class Solver {
+public:
+  explicit Solver(const Board &board);
+
+  // Forgets earlier deductions and solves the current board from scratch.
+  void solve();
+
+  // Keeps earlier deductions and re-propagates only the constraints around
+  // the given cells (bit indices revealed or flagged since the last call).
+  // Removing a flag can invalidate deductions; use solve() for that.
+  void update(const std::vector<uint32_t> &changed);
+
+  // Hidden cells proven safe or proven to be mines since the last solve(),
+  // as Board bit indices. After update() the lists may also hold cells the
+  // player has revealed or flagged in the meantime.
+  const std::vector<uint32_t> &safeCells() const { return safes; }
+  const std::vector<uint32_t> &mineCells() const { return mines; }
+
+  bool isKnownSafe(int x, int y) const;
+  bool isKnownMine(int x, int y) const;
+
+private:
+  const Board &board;
+  std::vector<uint64_t> knownSafe;
+  std::vector<uint64_t> knownMine;
+  std::vector<uint64_t> queued;
+  std::vector<uint32_t> worklist;
+  std::vector<uint32_t> safes;
+  std::vector<uint32_t> mines;
+
+  void clearKnowledge();
+  void seedFrontier();
+  void propagate();
+  void enqueueAround(int x, int y);
+  void processConstraint(int x, int y);
+  bool constraintAt(int x, int y, int originX, int originY, uint64_t &unknown,
+                    int &needed) const;
+  void settle(int originX, int originY, uint64_t cells, bool mine);
+};
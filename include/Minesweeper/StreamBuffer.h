@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <glad/glad.h>
+
+// Vertex memory for geometry rebuilt every frame. Where buffer storage is
+// available (GL 4.4) the buffer is mapped persistently and split into
+// kFrames regions used round-robin; a fence per region keeps the CPU from
+// overwriting vertices the GPU has not drawn yet. Older contexts orphan
+// the buffer each frame and upload with glBufferSubData instead.
+class StreamBuffer {
+public:
+  static constexpr int kFrames = 3;
+
+  explicit StreamBuffer(size_t bytesPerFrame);
+  ~StreamBuffer();
+
+  StreamBuffer(const StreamBuffer &) = delete;
+  StreamBuffer &operator=(const StreamBuffer &) = delete;
+
+  GLuint buffer() const { return VBO; }
+  bool persistent() const { return mapped != nullptr; }
+
+  // Bracket each frame's writes; beginFrame() waits only if the GPU is
+  // still reading the region from kFrames frames ago.
+  void beginFrame();
+  void endFrame();
+
+  // Copies whole vertices of `stride` bytes into this frame's region and
+  // returns the index of the first one, for glDrawArrays. False when the
+  // frame's region is full.
+  bool write(const void *data, size_t bytes, size_t stride,
+             GLint &firstVertex);
+  // Whole vertices of `stride` bytes that still fit this frame.
+  size_t available(size_t stride) const;
+
+private:
+  GLuint VBO = 0;
+  size_t frameBytes;
+  char *mapped = nullptr;
+  GLsync fences[kFrames] = {};
+  int frame = 0;
+  size_t used = 0;
+
+  size_t regionBase() const { return persistent() ? frame * frameBytes : 0; }
+  size_t alignedOffset(size_t stride) const;
+};
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "Shader.h"
+#include "StreamBuffer.h"
+
+// Screen-space text and flat 2D shapes, queued over a frame and drawn with
+// one glDrawArrays. Glyph quads come from stb_easy_font and are laid out
+// once per distinct string; later uses of the string only offset, scale and
+// tint the cached triangles. Every vertex carries its own color, so labels
+// of all colors share the draw. Positions are pixels from the bottom-left
+// corner of the framebuffer. `shader` must outlive the renderer.
+class TextRenderer {
+public:
+  enum class Anchor { TopLeft, Center };
+
+  TextRenderer(StreamBuffer &stream, const Shader &shader);
+  ~TextRenderer();
+
+  TextRenderer(const TextRenderer &) = delete;
+  TextRenderer &operator=(const TextRenderer &) = delete;
+
+  void addText(const std::string &text, float x, float y, float scale,
+               const glm::vec3 &color, Anchor anchor = Anchor::TopLeft);
+  // Three points per triangle.
+  void addTriangles(const glm::vec2 *points, size_t count,
+                    const glm::vec3 &color);
+
+  // Draws everything queued since the last call and clears the queue.
+  void Draw(int fbW, int fbH);
+
+private:
+  struct Vertex {
+    glm::vec2 position;
+    uint32_t color; // RGBA8
+  };
+
+  // Triangles in font units with the origin at the bottom-left of the
+  // string's bounds.
+  struct Layout {
+    std::vector<glm::vec2> triangles;
+    glm::vec2 size;
+  };
+
+  // Strings built at runtime ("Mines left: N") keep adding entries; the
+  // cache starts over once it holds this many.
+  static constexpr size_t kMaxLayouts = 512;
+
+  StreamBuffer &stream;
+  const Shader &shader;
+  Uniform<glm::mat4> projection;
+  GLuint VAO = 0;
+  std::vector<Vertex> vertices;
+  std::unordered_map<std::string, Layout> layouts;
+  std::vector<char> scratch;
+
+  const Layout &layout(const std::string &text);
+};
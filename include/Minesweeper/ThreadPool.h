@@ -0,0 +1,38 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads fed from a single task queue.
+class ThreadPool {
+public:
+  explicit ThreadPool(unsigned threads = std::thread::hardware_concurrency());
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+  void submit(std::function<void()> task);
+
+  // Runs body(i) for every i in [0, count) and returns once all calls have
+  // finished. The calling thread takes part, so nesting cannot deadlock.
+  void parallelFor(size_t count, const std::function<void(size_t)> &body);
+
+  // Process-wide pool sized to the hardware.
+  static ThreadPool &shared();
+
+private:
+  std::vector<std::thread> workers;
+  std::deque<std::function<void()>> tasks;
+  std::mutex mutex;
+  std::condition_variable wake;
+  bool stopping = false;
+
+  void workerLoop();
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "Cube.h"
+
+// One cube of the board: a uniform scale about `position`, with its color
+// looked up in the shader's palette uniform array.
+struct TileInstance {
+  glm::vec3 position;
+  float scale;
+  float reflectivity;
+  uint32_t palette;
+};
+
+// Draws every tile of the board with a single instanced draw of the cube
+// mesh. Instances live in a CPU mirror; writes through instance() mark a
+// dirty range that the next draw() uploads.
+class TileRenderer {
+public:
+  // Matches the palette array size in cube.vert.
+  static constexpr int kPaletteSize = 16;
+
+  explicit TileRenderer(const Cube &cube);
+  ~TileRenderer();
+
+  TileRenderer(const TileRenderer &) = delete;
+  TileRenderer &operator=(const TileRenderer &) = delete;
+
+  void resize(size_t count);
+  size_t size() const { return instances.size(); }
+
+  TileInstance &instance(size_t i) {
+    dirtyBegin = std::min(dirtyBegin, i);
+    dirtyEnd = std::max(dirtyEnd, i + 1);
+    return instances[i];
+  }
+
+  void Draw();
+
+private:
+  GLuint VAO = 0;
+  GLuint instanceVBO = 0;
+  std::vector<TileInstance> instances;
+  size_t dirtyBegin = 0;
+  size_t dirtyEnd = 0;
+};
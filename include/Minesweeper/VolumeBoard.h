@@ -0,0 +1,92 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Cell.h"
+#include "Random.h"
+
+// Volumetric W x H x D board with the 26-cell neighborhood. Storage follows
+// Board: packed bit-planes with each x-row padded to whole 64-bit words, rows
+// laid out z-major. Counts go up to 26 and are bit-sliced over five planes.
+class VolumeBoard {
+public:
+  enum Plane {
+    MinePlane,
+    RevealedPlane,
+    FlaggedPlane,
+    CountPlane0,
+    CountPlane1,
+    CountPlane2,
+    CountPlane3,
+    CountPlane4,
+    PlaneCount
+  };
+
+  int width, height, depth, mineCount;
+
+  VolumeBoard(int w, int h, int d, int mines, uint64_t seed);
+
+  void reset();
+  void reset(uint64_t seed);
+  uint64_t seed() const { return boardSeed; }
+
+  bool reveal(int x, int y, int z);
+  void toggleFlag(int x, int y, int z);
+  Cell get(int x, int y, int z) const;
+
+  bool isMine(int x, int y, int z) const;
+  bool isRevealed(int x, int y, int z) const;
+  bool isFlagged(int x, int y, int z) const;
+  int neighborCount(int x, int y, int z) const;
+
+  size_t lastRevealCount() const { return revealQueue.size(); }
+  int hiddenSafeCount() const { return hiddenSafe; }
+  int flagCount() const { return flagsPlaced; }
+  int minesRemaining() const { return minesPlaced - flagsPlaced; }
+  bool checkWin() const { return hiddenSafe == 0; }
+
+  void calculateNumbers();
+  void revealAllMines();
+
+  // World-space center of a cell when the volume is drawn centered on the
+  // origin with the given cell spacing.
+  glm::vec3 cellCenter(int x, int y, int z, float spacing) const;
+
+  // Walks the ray through the grid (3D DDA) and returns the first cell that
+  // is still hidden or flagged; revealed cells are treated as open space.
+  bool pick(const glm::vec3 &origin, const glm::vec3 &direction,
+            float spacing, float maxDistance, int &outX, int &outY,
+            int &outZ) const;
+
+  size_t wordsPerRow() const { return rowWords; }
+  size_t wordsPerPlane() const { return planeWords; }
+  const uint64_t *plane(Plane p) const {
+    return storage.data() + static_cast<size_t>(p) * planeWords;
+  }
+  size_t bitIndex(int x, int y, int z) const {
+    return (static_cast<size_t>(z) * height + y) * rowWords * 64 +
+           static_cast<size_t>(x);
+  }
+
+private:
+  size_t rowWords;
+  size_t planeWords;
+  std::vector<uint64_t> storage;
+  std::vector<uint32_t> revealQueue;
+  Random rng;
+  uint64_t boardSeed = 0;
+  bool firstMove = true;
+  int hiddenSafe = 0;
+  int flagsPlaced = 0;
+  int minesPlaced = 0;
+
+  uint64_t *mutablePlane(Plane p) {
+    return storage.data() + static_cast<size_t>(p) * planeWords;
+  }
+  int countAt(size_t bit) const;
+  void setCountAt(size_t bit, int count);
+  void cellAt(size_t bit, int &x, int &y, int &z) const;
+  void placeMines();
+  void relocateMine(int x, int y, int z);
+};
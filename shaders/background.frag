@@ -3,7 +3,14 @@ out vec4 FragColor;
 
 in vec2 vUV;
 
-uniform float time;
+layout (std140, binding = 0) uniform Frame {
+    mat4 projection;
+    mat4 view;
+    mat4 skyView;
+    mat4 skyRotation;
+    vec4 cameraPos;
+    float time;
+};
 
 float hash(vec2 p)
 {
@@ -1,18 +1,34 @@
 #version 430 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
+// per instance: xyz offset and w uniform scale, reflectivity, palette index
+layout (location = 2) in vec4 aOffsetScale;
+layout (location = 3) in float aReflectivity;
+layout (location = 4) in uint aPalette;
 
 out vec3 FragPos;
 out vec3 Normal;
+flat out vec3 Color;
+flat out float Reflectivity;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140, binding = 0) uniform Frame {
+    mat4 projection;
+    mat4 view;
+    mat4 skyView;
+    mat4 skyRotation;
+    vec4 cameraPos;
+    float time;
+};
+
+uniform vec3 palette[16];
 
 void main()
 {
-    vec4 worldPos = model * vec4(aPos, 1.0);
-    FragPos = worldPos.xyz;
-    Normal = mat3(transpose(inverse(model))) * aNormal;
-    gl_Position = projection * view * worldPos;
+    vec3 worldPos = aOffsetScale.xyz + aPos * aOffsetScale.w;
+    FragPos = worldPos;
+    // translation and uniform scale leave normals unchanged
+    Normal = aNormal;
+    Color = palette[aPalette];
+    Reflectivity = aReflectivity;
+    gl_Position = projection * view * vec4(worldPos, 1.0);
 }
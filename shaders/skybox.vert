@@ -3,11 +3,17 @@ layout (location = 0) in vec3 aPos;
 
 out vec3 vDirection;
 
-uniform mat4 projection;
-uniform mat4 view;
+layout (std140, binding = 0) uniform Frame {
+    mat4 projection;
+    mat4 view;
+    mat4 skyView;
+    mat4 skyRotation;
+    vec4 cameraPos;
+    float time;
+};
 
 void main() {
     vDirection = aPos;
-    vec4 pos = projection * view * vec4(aPos, 1.0);
+    vec4 pos = projection * skyView * vec4(aPos, 1.0);
     gl_Position = pos.xyww;
 }
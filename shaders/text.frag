@@ -1,8 +1,7 @@
 #version 430 core
+in vec3 Color;
 out vec4 FragColor;
 
-uniform vec3 textColor;
-
 void main() {
-  FragColor = vec4(textColor, 1.0);
+  FragColor = vec4(Color, 1.0);
 }
@@ -1,8 +1,12 @@
 #version 430 core
 layout(location = 0) in vec2 aPos;
+layout(location = 1) in vec4 aColor;
 
 uniform mat4 projection;
 
+out vec3 Color;
+
 void main() {
+  Color = aColor.rgb;
   gl_Position = projection * vec4(aPos, 0.0, 1.0);
 }
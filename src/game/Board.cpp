@@ -1,155 +1,779 @@
 #include "Minesweeper/Board.h"
+#include "Minesweeper/BitOps.h"
+#include "Minesweeper/NeighborCount.h"
+#include "Minesweeper/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <ctime>
+#include <functional>
 #include <vector>
 
+namespace {
+// Rows per generation band. Fixed so layouts are independent of the thread
+// count; boards smaller than kParallelCells are generated inline.
+constexpr int kBandRows = 64;
+constexpr int kParallelCells = 1 << 18;
+
+std::atomic<uint64_t> nextChangeGeneration{0};
+
+// Mines among `draws` cells picked from `population` cells of which
+// `successes` are mines: a hypergeometric draw, by inversion over the pmf.
+// Terms come from the ratio p(k + 1) / p(k), walked out from the mode until
+// they drop below 1e-18 of it, so the work is proportional to the standard
+// deviation rather than to the band size.
+int64_t hypergeometric(int64_t population, int64_t successes, int64_t draws,
+                       Random &rng, std::vector<double> &terms) {
+  const int64_t low = std::max<int64_t>(0, draws - (population - successes));
+  const int64_t high = std::min(draws, successes);
+  if (low == high)
+    return low;
+  const int64_t mode = std::clamp<int64_t>(
+      static_cast<int64_t>((double(draws) + 1) * (double(successes) + 1) /
+                           (double(population) + 2)),
+      low, high);
+  auto up = [&](int64_t k) { // p(k + 1) / p(k)
+    return double(successes - k) * double(draws - k) /
+           (double(k + 1) * double(population - successes - draws + k + 1));
+  };
+  constexpr double kCutoff = 1e-18;
+
+  int64_t first = mode;
+  double term = 1.0;
+  while (first > low && (term /= up(first - 1)) >= kCutoff)
+    --first;
+  terms.clear();
+  term = 1.0;
+  for (int64_t k = mode; k > first; --k)
+    term /= up(k - 1);
+  double total = 0.0;
+  for (int64_t k = first; k <= high && (k <= mode || term >= kCutoff); ++k) {
+    terms.push_back(term);
+    total += term;
+    term *= up(k);
+  }
+
+  double u = static_cast<double>(rng.next() >> 11) * 0x1p-53 * total;
+  for (size_t i = 0; i < terms.size(); ++i) {
+    if (u < terms[i])
+      return first + static_cast<int64_t>(i);
+    u -= terms[i];
+  }
+  return first + static_cast<int64_t>(terms.size()) - 1;
+}
+
+} // namespace
+
 Board::Board(int w, int h, int mines)
-    : width(w), height(h), mineCount(mines), cells(w * h), firstMove(true) {
-  srand(time(nullptr));
-  reset();
+    : Board(w, h, mines, static_cast<uint64_t>(time(nullptr))) {}
+
+Board::Board(int w, int h, int mines, uint64_t seed)
+    : width(w), height(h), mineCount(mines),
+      rowWords((static_cast<size_t>(w) + 63) / 64),
+      planeWords(rowWords * static_cast<size_t>(h)),
+      storage(planeWords * PlaneCount), firstMove(true) {
+  reset(seed);
 }
 
-void Board::calculateNumbers() {
-  for (int x = 0; x < width; ++x) {
-    for (int y = 0; y < height; ++y) {
-      if (get(x, y).type == CellType::Mine)
-        continue;
+int Board::countAt(size_t bit) const {
+  return testBit(plane(CountPlane0), bit) |
+         (testBit(plane(CountPlane1), bit) << 1) |
+         (testBit(plane(CountPlane2), bit) << 2) |
+         (testBit(plane(CountPlane3), bit) << 3);
+}
 
-      int count = 0;
-      for (int dx = -1; dx <= 1; ++dx) {
-        for (int dy = -1; dy <= 1; ++dy) {
-          int nx = x + dx;
-          int ny = y + dy;
-          if (nx >= 0 && nx < width && ny >= 0 && ny < height) {
-            if (get(nx, ny).type == CellType::Mine)
-              count++;
-          }
-        }
-      }
-      get(x, y).neighborMines = count; // use the correct member in Cell
-    }
+void Board::setCountAt(size_t bit, int count) {
+  for (int k = 0; k < 4; ++k) {
+    uint64_t *p = mutablePlane(static_cast<Plane>(CountPlane0 + k));
+    if ((count >> k) & 1)
+      setBit(p, bit);
+    else
+      clearBit(p, bit);
   }
 }
 
-bool Board::checkWin() {
-  for (int x = 0; x < width; ++x) {
-    for (int y = 0; y < height; ++y) {
-      if (get(x, y).type == CellType::Empty &&
-          get(x, y).state != CellState::Revealed)
-        return false;
-    }
-  }
-  return true;
+void Board::calculateNumbers() {
+  uint64_t *const counts[4] = {
+      mutablePlane(CountPlane0), mutablePlane(CountPlane1),
+      mutablePlane(CountPlane2), mutablePlane(CountPlane3)};
+#ifdef MINESWEEPER_SCALAR_COUNTS
+  countNeighborsScalar(plane(MinePlane), rowWords, width, height, counts, 0,
+                       height);
+#else
+  countNeighborsBitSliced(plane(MinePlane), rowWords, width, height, counts, 0,
+                          height);
+#endif
+  restartChangeLog();
 }
 
-void Board::reset() {
-  for (auto &c : cells) {
-    c.state = CellState::Hidden;
-    c.type = CellType::Empty;
-    c.neighborMines = 0;
-  }
+void Board::reset() { reset(rng.next()); }
 
+void Board::reset(uint64_t newSeed) {
+  boardSeed = newSeed;
+  rng.reseed(newSeed);
   firstMove = true;
+  journal.clear();
+  restartChangeLog();
+  const int cellCount = width * height;
+  minesPlaced = std::clamp(mineCount, 0, cellCount);
+  hiddenSafe = cellCount - minesPlaced;
+  flagsPlaced = 0;
 
-  // place mines
-  int placed = 0;
-  while (placed < mineCount) {
-    int idx = rand() % (width * height);
-    if (cells[idx].type == CellType::Mine)
-      continue;
-    cells[idx].type = CellType::Mine;
-    placed++;
+  // Generation runs in fixed bands of rows, each with its own RNG stream
+  // derived from (seed, band), so the layout does not depend on how many
+  // threads process the bands. Band mine counts follow the multivariate
+  // hypergeometric split of a uniform layout: each band draws its count
+  // from the cells and mines the bands before it left over.
+  const int bands = (height + kBandRows - 1) / kBandRows;
+  std::vector<int> bandMines(bands);
+  std::vector<double> terms;
+  int64_t cellsLeft = cellCount, minesLeft = minesPlaced;
+  for (int band = 0; band < bands; ++band) {
+    const int64_t bandCells =
+        static_cast<int64_t>(std::min(kBandRows, height - band * kBandRows)) *
+        width;
+    bandMines[band] = static_cast<int>(
+        hypergeometric(cellsLeft, minesLeft, bandCells, rng, terms));
+    cellsLeft -= bandCells;
+    minesLeft -= bandMines[band];
   }
 
-  // count neighbors
-  for (int y = 0; y < height; ++y)
-    for (int x = 0; x < width; ++x) {
-      if (get(x, y).type == CellType::Mine)
-        continue;
-      int count = 0;
-      for (int dy = -1; dy <= 1; ++dy)
-        for (int dx = -1; dx <= 1; ++dx) {
-          if (!dx && !dy)
-            continue;
-          int nx = x + dx, ny = y + dy;
-          if (nx >= 0 && nx < width && ny >= 0 && ny < height &&
-              get(nx, ny).type == CellType::Mine)
-            count++;
-        }
-      get(x, y).neighborMines = count;
+  auto forEachBand = [&](const std::function<void(size_t)> &body) {
+    if (cellCount >= kParallelCells)
+      ThreadPool::shared().parallelFor(bands, body);
+    else
+      for (int band = 0; band < bands; ++band)
+        body(band);
+  };
+
+  forEachBand([&](size_t band) {
+    const int rowBegin = static_cast<int>(band) * kBandRows;
+    const int rowEnd = std::min(rowBegin + kBandRows, height);
+    for (int p = 0; p < PlaneCount; ++p) {
+      uint64_t *words = mutablePlane(static_cast<Plane>(p));
+      std::fill(words + rowBegin * rowWords, words + rowEnd * rowWords, 0);
     }
+    uint64_t streamState = newSeed ^ (band * 0xd1b54a32d192ed03ull);
+    Random bandRng(Random::splitmix64(streamState));
+    placeMines(rowBegin, rowEnd, bandMines[band], bandRng);
+  });
+
+  // counts read one halo row from each neighboring band, so they run as a
+  // second pass once every band's mines are in place
+  uint64_t *const counts[4] = {
+      mutablePlane(CountPlane0), mutablePlane(CountPlane1),
+      mutablePlane(CountPlane2), mutablePlane(CountPlane3)};
+  forEachBand([&](size_t band) {
+    const int rowBegin = static_cast<int>(band) * kBandRows;
+    const int rowEnd = std::min(rowBegin + kBandRows, height);
+    countNeighborsBitSliced(plane(MinePlane), rowWords, width, height, counts,
+                            rowBegin, rowEnd);
+  });
+}
+
+void Board::placeMines(int rowBegin, int rowEnd, int count, Random &bandRng) {
+  // Floyd's sampling picks k distinct cells with exactly k draws, using the
+  // mine plane itself as the membership set. Above 50% density the safe
+  // cells are sampled instead and the band is inverted.
+  uint64_t *mines = mutablePlane(MinePlane);
+  const int cellCount = (rowEnd - rowBegin) * width;
+  const bool invert = count > cellCount / 2;
+  const int picks = invert ? cellCount - count : count;
+
+  for (int j = cellCount - picks; j < cellCount; ++j) {
+    int t = static_cast<int>(bandRng.below(static_cast<uint64_t>(j) + 1));
+    size_t bit = bitIndex(t % width, rowBegin + t / width);
+    if (testBit(mines, bit))
+      bit = bitIndex(j % width, rowBegin + j / width);
+    setBit(mines, bit);
+  }
+
+  if (invert) {
+    const uint64_t tailMask = rowTailMask(width);
+    for (int y = rowBegin; y < rowEnd; ++y)
+      for (size_t w = 0; w < rowWords; ++w) {
+        uint64_t &word = mines[y * rowWords + w];
+        word = ~word & (w + 1 == rowWords ? tailMask : ~uint64_t(0));
+      }
+  }
+}
+
+Cell Board::get(int x, int y) const {
+  const size_t bit = bitIndex(x, y);
+  Cell cell;
+  cell.type = testBit(plane(MinePlane), bit) ? CellType::Mine : CellType::Empty;
+  if (testBit(plane(RevealedPlane), bit))
+    cell.state = CellState::Revealed;
+  else if (testBit(plane(FlaggedPlane), bit))
+    cell.state = CellState::Flagged;
+  cell.neighborMines = countAt(bit);
+  return cell;
 }
 
-Cell &Board::get(int x, int y) { return cells[y * width + x]; }
-const Cell &Board::get(int x, int y) const { return cells[y * width + x]; }
+bool Board::isMine(int x, int y) const {
+  return testBit(plane(MinePlane), bitIndex(x, y));
+}
+
+bool Board::isRevealed(int x, int y) const {
+  return testBit(plane(RevealedPlane), bitIndex(x, y));
+}
+
+bool Board::isFlagged(int x, int y) const {
+  return testBit(plane(FlaggedPlane), bitIndex(x, y));
+}
+
+int Board::neighborCount(int x, int y) const { return countAt(bitIndex(x, y)); }
+
+bool Board::flipFlag(size_t bit) {
+  if (testBit(plane(RevealedPlane), bit))
+    return false;
+  uint64_t *flagged = mutablePlane(FlaggedPlane);
+  flagsPlaced += testBit(flagged, bit) ? -1 : 1;
+  flipBit(flagged, bit);
+  return true;
+}
 
 void Board::toggleFlag(int x, int y) {
-  if (get(x, y).state == CellState::Hidden)
-    get(x, y).state = CellState::Flagged;
-  else if (get(x, y).state == CellState::Flagged)
-    get(x, y).state = CellState::Hidden;
+  const size_t bit = bitIndex(x, y);
+  if (!flipFlag(bit))
+    return;
+  logChange(static_cast<uint32_t>(bit));
+
+  journalRecord.clear();
+  journalRecord.push_back(FlagOp);
+  MoveJournal::putVarint(journalRecord, bit);
+  journal.append(journalRecord);
 }
 
 bool Board::reveal(int x, int y) {
-  Cell &cell = get(x, y);
-  if (cell.state != CellState::Hidden)
+  const bool firstReveal = firstMove;
+  const bool hitMine = revealCells(x, y);
+  if (revealQueue.empty())
+    return false;
+  logChanges(revealQueue);
+  markJournalCells(revealQueue);
+  recordReveal(hitMine ? 1 : 0, firstReveal);
+  return hitMine;
+}
+
+bool Board::revealCells(int x, int y) {
+  revealQueue.clear();
+  const size_t bit = bitIndex(x, y);
+  if (testBit(plane(RevealedPlane), bit) || testBit(plane(FlaggedPlane), bit))
     return false;
 
   if (firstMove) {
     firstMove = false;
-    if (cell.type == CellType::Mine) {
-      relocateMine(x, y);
-    }
+    relocations.clear();
+    const int radius = safeOpening ? 1 : 0;
+    for (int dy = -radius; dy <= radius; ++dy)
+      for (int dx = -radius; dx <= radius; ++dx) {
+        int nx = x + dx, ny = y + dy;
+        if (nx >= 0 && nx < width && ny >= 0 && ny < height &&
+            isMine(nx, ny))
+          relocateMine(nx, ny, x, y, radius);
+      }
+    logMovedMines(relocations);
   }
 
-  if (cell.state != CellState::Hidden)
+  uint64_t *revealed = mutablePlane(RevealedPlane);
+  setBit(revealed, bit);
+  revealQueue.push_back(static_cast<uint32_t>(bit));
+  if (testBit(plane(MinePlane), bit))
+    return true;
+
+  floodFill();
+  hiddenSafe -= static_cast<int>(revealQueue.size());
+  return false;
+}
+
+bool Board::chord(int x, int y) {
+  const int mines = chordCells(x, y);
+  if (revealQueue.empty())
     return false;
-  cell.state = CellState::Revealed;
+  logChanges(revealQueue);
+  markJournalCells(revealQueue);
+  recordReveal(mines, false);
+  return mines > 0;
+}
 
-  if (cell.type == CellType::Mine) {
-    return true;
+int Board::chordCells(int x, int y) {
+  revealQueue.clear();
+  const size_t bit = bitIndex(x, y);
+  if (!testBit(plane(RevealedPlane), bit) || testBit(plane(MinePlane), bit))
+    return 0;
+
+  int flags = 0;
+  for (int dy = -1; dy <= 1; ++dy)
+    for (int dx = -1; dx <= 1; ++dx) {
+      int nx = x + dx, ny = y + dy;
+      if (nx >= 0 && nx < width && ny >= 0 && ny < height)
+        flags += testBit(plane(FlaggedPlane), bitIndex(nx, ny));
+    }
+  if (flags != countAt(bit))
+    return 0;
+
+  // Safe neighbors seed the flood fill; mines join the queue after it so
+  // they are never expanded.
+  uint64_t *revealed = mutablePlane(RevealedPlane);
+  int mines = 0;
+  uint32_t mineBits[8];
+  for (int dy = -1; dy <= 1; ++dy)
+    for (int dx = -1; dx <= 1; ++dx) {
+      int nx = x + dx, ny = y + dy;
+      if (nx < 0 || nx >= width || ny < 0 || ny >= height)
+        continue;
+      const size_t next = bitIndex(nx, ny);
+      if (testBit(revealed, next) || testBit(plane(FlaggedPlane), next))
+        continue;
+      setBit(revealed, next);
+      if (testBit(plane(MinePlane), next))
+        mineBits[mines++] = static_cast<uint32_t>(next);
+      else
+        revealQueue.push_back(static_cast<uint32_t>(next));
+    }
+
+  floodFill();
+  hiddenSafe -= static_cast<int>(revealQueue.size());
+  revealQueue.insert(revealQueue.end(), mineBits, mineBits + mines);
+  return mines;
+}
+
+void Board::apply(const Move *moves, size_t count, MoveResult &result) {
+  result.hitMine = false;
+  result.movesApplied = 0;
+  result.cellsRevealed = 0;
+  result.changed.clear();
+  batchFlags.clear();
+  const bool wasFirstMove = firstMove;
+  int minesHit = 0;
+  for (size_t i = 0; i < count && !minesHit; ++i) {
+    const Move &move = moves[i];
+    result.movesApplied++;
+    switch (move.kind) {
+    case Move::Reveal:
+      minesHit += revealCells(move.x, move.y);
+      break;
+    case Move::Chord:
+      minesHit += chordCells(move.x, move.y);
+      break;
+    case Move::Flag: {
+      const size_t bit = bitIndex(move.x, move.y);
+      if (flipFlag(bit)) {
+        result.changed.push_back(static_cast<uint32_t>(bit));
+        batchFlags.push_back(static_cast<uint32_t>(bit));
+      }
+      revealQueue.clear();
+      continue;
+    }
+    }
+    if (revealQueue.empty())
+      continue;
+    result.cellsRevealed += revealQueue.size();
+    result.changed.insert(result.changed.end(), revealQueue.begin(),
+                          revealQueue.end());
+    markJournalCells(revealQueue);
   }
+  result.hitMine = minesHit > 0;
+  if (result.changed.empty())
+    return;
+
+  // The whole batch is one change-log append and one journal record, so
+  // it is also a single undo step.
+  logChanges(result.changed);
+  recordReveal(minesHit, wasFirstMove && !firstMove, &batchFlags);
+}
 
-  if (cell.neighborMines == 0) {
-    for (int dy = -1; dy <= 1; ++dy)
+void Board::floodFill() {
+  // Breadth-first flood fill. A cell is marked revealed when it is queued, so
+  // each cell enters the queue at most once; only zero-count cells expand.
+  uint64_t *revealed = mutablePlane(RevealedPlane);
+  const uint64_t *flagged = plane(FlaggedPlane);
+  const size_t rowBits = rowWords * 64;
+  for (size_t head = 0; head < revealQueue.size(); ++head) {
+    const size_t cur = revealQueue[head];
+    if (countAt(cur) != 0)
+      continue;
+
+    const int cx = static_cast<int>(cur % rowBits);
+    const int cy = static_cast<int>(cur / rowBits);
+    for (int dy = -1; dy <= 1; ++dy) {
+      int ny = cy + dy;
+      if (ny < 0 || ny >= height)
+        continue;
       for (int dx = -1; dx <= 1; ++dx) {
-        if (dx == 0 && dy == 0)
+        int nx = cx + dx;
+        if ((dx == 0 && dy == 0) || nx < 0 || nx >= width)
           continue;
-        int nx = x + dx, ny = y + dy;
-        if (nx >= 0 && nx < width && ny >= 0 && ny < height)
-          reveal(nx, ny);
+        size_t next = bitIndex(nx, ny);
+        if (testBit(revealed, next) || testBit(flagged, next))
+          continue;
+        setBit(revealed, next);
+        revealQueue.push_back(static_cast<uint32_t>(next));
       }
+    }
+  }
+}
+
+void Board::revealAllMines() {
+  const uint64_t *mines = plane(MinePlane);
+  uint64_t *revealed = mutablePlane(RevealedPlane);
+  uint64_t *flagged = mutablePlane(FlaggedPlane);
+
+  // journal the mines about to be uncovered and the flags about to go
+  journalSpans[0].clear();
+  journalSpans[1].clear();
+  for (size_t i = 0; i < planeWords; ++i) {
+    // flagged mines are hidden too, so the first set covers every change
+    uint64_t uncovered = mines[i] & ~revealed[i];
+    journalSpans[0].addWord(i, uncovered);
+    journalSpans[1].addWord(i, mines[i] & flagged[i]);
+    for (; uncovered; uncovered &= uncovered - 1)
+      logChange(static_cast<uint32_t>(i * 64 +
+                                      countTrailingZeros64(uncovered)));
+  }
+  journalRecord.clear();
+  journalRecord.push_back(RevealAllMinesOp);
+  journalSpans[0].write(journalRecord);
+  journalSpans[1].write(journalRecord);
+  journal.append(journalRecord);
+
+  flagsPlaced = 0;
+  for (size_t i = 0; i < planeWords; ++i) {
+    revealed[i] |= mines[i];
+    flagged[i] &= ~mines[i];
+    flagsPlaced += popcount64(flagged[i]);
+  }
+}
+
+void Board::addMine(int x, int y) {
+  setBit(mutablePlane(MinePlane), bitIndex(x, y));
+  setCountAt(bitIndex(x, y), 0);
+  for (int dy = -1; dy <= 1; ++dy)
+    for (int dx = -1; dx <= 1; ++dx) {
+      int nx = x + dx, ny = y + dy;
+      if ((dx || dy) && nx >= 0 && nx < width && ny >= 0 && ny < height &&
+          !isMine(nx, ny)) {
+        size_t n = bitIndex(nx, ny);
+        setCountAt(n, countAt(n) + 1);
+      }
+    }
+}
+
+void Board::removeMine(int x, int y) {
+  clearBit(mutablePlane(MinePlane), bitIndex(x, y));
+  int count = 0;
+  for (int dy = -1; dy <= 1; ++dy)
+    for (int dx = -1; dx <= 1; ++dx) {
+      int nx = x + dx, ny = y + dy;
+      if (!(dx || dy) || nx < 0 || nx >= width || ny < 0 || ny >= height)
+        continue;
+      if (isMine(nx, ny)) {
+        count++;
+      } else {
+        size_t n = bitIndex(nx, ny);
+        setCountAt(n, countAt(n) - 1);
+      }
+    }
+  setCountAt(bitIndex(x, y), count);
+}
+
+bool Board::findRelocationTarget(int safeX, int safeY, int radius, int &outX,
+                                 int &outY) {
+  auto inSafeZone = [&](int x, int y) {
+    return std::abs(x - safeX) <= radius && std::abs(y - safeY) <= radius;
+  };
+
+  // random probing finds a free cell in O(1) expected time unless the board
+  // is nearly full of mines
+  const int cellCount = width * height;
+  for (int attempt = 0; attempt < 64; ++attempt) {
+    int idx = static_cast<int>(rng.below(cellCount));
+    int x = idx % width, y = idx / width;
+    if (!isMine(x, y) && !inSafeZone(x, y)) {
+      outX = x;
+      outY = y;
+      return true;
+    }
   }
 
+  // dense board: scan the mine plane a word at a time from a random row
+  const uint64_t *mines = plane(MinePlane);
+  const uint64_t tailMask = rowTailMask(width);
+  const int startRow = static_cast<int>(rng.below(height));
+  for (int i = 0; i < height; ++i) {
+    int y = (startRow + i) % height;
+    for (size_t w = 0; w < rowWords; ++w) {
+      uint64_t free = ~mines[y * rowWords + w];
+      if (w + 1 == rowWords)
+        free &= tailMask;
+      while (free) {
+        int x = static_cast<int>(w * 64) + countTrailingZeros64(free);
+        free &= free - 1;
+        if (!inSafeZone(x, y)) {
+          outX = x;
+          outY = y;
+          return true;
+        }
+      }
+    }
+  }
   return false;
 }
 
-void Board::revealAllMines() {
-  for (auto &cell : cells) {
-    if (cell.type == CellType::Mine)
-      cell.state = CellState::Revealed;
+void Board::relocateMine(int mineX, int mineY, int safeX, int safeY,
+                         int radius) {
+  removeMine(mineX, mineY);
+  relocations.push_back(static_cast<uint32_t>(bitIndex(mineX, mineY)) + 1);
+
+  int targetX = 0, targetY = 0;
+  if (findRelocationTarget(safeX, safeY, radius, targetX, targetY)) {
+    addMine(targetX, targetY);
+    relocations.push_back(static_cast<uint32_t>(bitIndex(targetX, targetY)) +
+                          1);
+  } else {
+    relocations.push_back(0);
+    // no room for the mine: it leaves the board and the cell becomes safe
+    --minesPlaced;
+    ++hiddenSafe;
+  }
+}
+
+void Board::markJournalCells(const std::vector<uint32_t> &cells) {
+  // Mark the cells in a scratch plane, remembering each word the first time
+  // it is touched; only those words are sorted and turned into spans, so a
+  // flood fill costs O(cells) rather than a sort over cells.
+  journalMarks.resize(planeWords);
+  for (uint32_t bit : cells) {
+    uint64_t &word = journalMarks[bit >> 6];
+    if (!word)
+      journalWords.push_back(bit >> 6);
+    word |= uint64_t(1) << (bit & 63);
   }
 }
 
-void Board::relocateMine(int safeX, int safeY) {
-  const int safeIndex = safeY * width + safeX;
-  cells[safeIndex].type = CellType::Empty;
-  cells[safeIndex].state = CellState::Hidden;
+void Board::recordReveal(int minesHit, bool firstReveal,
+                         const std::vector<uint32_t> *flagsToggled) {
+  const bool hasFlags = flagsToggled && !flagsToggled->empty();
+  journalRecord.clear();
+  journalRecord.push_back(RevealOp);
+  journalRecord.push_back((minesHit ? HitMine : 0) |
+                          (firstReveal ? FirstReveal : 0) |
+                          (hasFlags ? FlagsToggled : 0));
+  if (minesHit)
+    MoveJournal::putVarint(journalRecord, minesHit);
+  if (firstReveal) {
+    MoveJournal::putVarint(journalRecord, relocations.size() / 2);
+    for (uint32_t cell : relocations)
+      MoveJournal::putVarint(journalRecord, cell);
+  }
 
-  std::vector<int> candidates;
-  candidates.reserve(cells.size());
-  for (int i = 0; i < static_cast<int>(cells.size()); ++i) {
-    if (i == safeIndex)
-      continue;
-    if (cells[i].type != CellType::Mine)
-      candidates.push_back(i);
+  journalSpans[0].clear();
+  if (journalWords.size() * 16 > planeWords) {
+    // a batch touching much of the board: a scan beats the sort
+    for (size_t w = 0; w < planeWords; ++w)
+      if (journalMarks[w]) {
+        journalSpans[0].addWord(w, journalMarks[w]);
+        journalMarks[w] = 0;
+      }
+  } else {
+    std::sort(journalWords.begin(), journalWords.end());
+    for (uint32_t w : journalWords) {
+      journalSpans[0].addWord(w, journalMarks[w]);
+      journalMarks[w] = 0;
+    }
+  }
+  journalWords.clear();
+  journalSpans[0].write(journalRecord);
+
+  // flips commute, so the flags go in as toggled, repeats and all
+  if (hasFlags) {
+    MoveJournal::putVarint(journalRecord, flagsToggled->size());
+    for (uint32_t bit : *flagsToggled)
+      MoveJournal::putVarint(journalRecord, bit);
+  }
+  journal.append(journalRecord);
+}
+
+void Board::moveMine(uint32_t from, uint32_t to) {
+  // cells are bit index + 1; zero stands for off the board
+  const size_t rowBits = rowWords * 64;
+  if (from) {
+    removeMine(static_cast<int>((from - 1) % rowBits),
+               static_cast<int>((from - 1) / rowBits));
+  } else {
+    ++minesPlaced;
+    --hiddenSafe;
   }
+  if (to) {
+    addMine(static_cast<int>((to - 1) % rowBits),
+            static_cast<int>((to - 1) / rowBits));
+  } else {
+    --minesPlaced;
+    ++hiddenSafe;
+  }
+}
+
+void Board::replayReveal(MoveJournal::Reader &record, bool forward) {
+  const uint8_t flags = record.byte();
+  const int minesHit =
+      (flags & HitMine) ? static_cast<int>(record.varint()) : 0;
+  journalCells.clear();
+  if (flags & FirstReveal)
+    for (uint64_t n = record.varint() * 2; n > 0; --n)
+      journalCells.push_back(static_cast<uint32_t>(record.varint()));
+
+  // mines move before the reveal and move back after it is undone
+  if (forward && (flags & FirstReveal)) {
+    for (size_t i = 0; i < journalCells.size(); i += 2)
+      moveMine(journalCells[i], journalCells[i + 1]);
+    firstMove = false;
+    logMovedMines(journalCells);
+  }
+  uint64_t *revealed = mutablePlane(RevealedPlane);
+  const size_t cells = record.spans([&](size_t begin, size_t end) {
+    fillBitRange(revealed, begin, end, forward);
+    logChangedRange(begin, end);
+  });
+  const int safeCells = static_cast<int>(cells) - minesHit;
+  hiddenSafe += forward ? -safeCells : safeCells;
+  // flips are their own inverse, so both directions apply the same list
+  if (flags & FlagsToggled) {
+    uint64_t *flagged = mutablePlane(FlaggedPlane);
+    for (uint64_t n = record.varint(); n > 0; --n) {
+      const size_t bit = record.varint();
+      flagsPlaced += testBit(flagged, bit) ? -1 : 1;
+      flipBit(flagged, bit);
+      logChange(static_cast<uint32_t>(bit));
+    }
+  }
+  if (!forward && (flags & FirstReveal)) {
+    for (size_t i = journalCells.size(); i > 0; i -= 2)
+      moveMine(journalCells[i - 1], journalCells[i - 2]);
+    firstMove = true;
+    logMovedMines(journalCells);
+  }
+}
+
+void Board::replayRevealAllMines(MoveJournal::Reader &record, bool forward) {
+  uint64_t *revealed = mutablePlane(RevealedPlane);
+  uint64_t *flagged = mutablePlane(FlaggedPlane);
+  record.spans([&](size_t begin, size_t end) {
+    fillBitRange(revealed, begin, end, forward);
+    logChangedRange(begin, end);
+  });
+  const size_t flags = record.spans([&](size_t begin, size_t end) {
+    fillBitRange(flagged, begin, end, !forward);
+  });
+  flagsPlaced += forward ? -static_cast<int>(flags) : static_cast<int>(flags);
+}
+
+bool Board::mineRevealed() const {
+  const uint64_t *mines = plane(MinePlane);
+  const uint64_t *revealed = plane(RevealedPlane);
+  for (size_t i = 0; i < planeWords; ++i)
+    if (mines[i] & revealed[i])
+      return true;
+  return false;
+}
+
+bool Board::undo() {
+  if (!journal.canUndo())
+    return false;
+  revealQueue.clear();
+  MoveJournal::Reader record = journal.undo();
+  switch (record.byte()) {
+  case RevealOp:
+    replayReveal(record, false);
+    break;
+  case FlagOp: {
+    const size_t bit = record.varint();
+    flagsPlaced += testBit(plane(FlaggedPlane), bit) ? -1 : 1;
+    flipBit(mutablePlane(FlaggedPlane), bit);
+    logChange(static_cast<uint32_t>(bit));
+    break;
+  }
+  case RevealAllMinesOp:
+    replayRevealAllMines(record, false);
+    break;
+  }
+  return true;
+}
+
+bool Board::redo() {
+  if (!journal.canRedo())
+    return false;
+  revealQueue.clear();
+  MoveJournal::Reader record = journal.redo();
+  switch (record.byte()) {
+  case RevealOp:
+    replayReveal(record, true);
+    break;
+  case FlagOp: {
+    const size_t bit = record.varint();
+    flagsPlaced += testBit(plane(FlaggedPlane), bit) ? -1 : 1;
+    flipBit(mutablePlane(FlaggedPlane), bit);
+    logChange(static_cast<uint32_t>(bit));
+    break;
+  }
+  case RevealAllMinesOp:
+    replayRevealAllMines(record, true);
+    break;
+  }
+  return true;
+}
+
+// Past this size a full resync is as cheap as replaying the log.
+size_t Board::changeLogLimit() const {
+  return static_cast<size_t>(width) * height / 8 + 4096;
+}
+
+void Board::logChange(uint32_t bit) {
+  if (changeLog.bits.size() >= changeLogLimit())
+    restartChangeLog();
+  changeLog.bits.push_back(bit);
+}
+
+void Board::logChanges(const std::vector<uint32_t> &bits) {
+  if (changeLog.bits.size() + bits.size() > changeLogLimit())
+    restartChangeLog();
+  else
+    changeLog.bits.insert(changeLog.bits.end(), bits.begin(), bits.end());
+}
+
+void Board::logChangedRange(size_t begin, size_t end) {
+  if (changeLog.bits.size() + (end - begin) > changeLogLimit()) {
+    restartChangeLog();
+    return;
+  }
+  for (size_t bit = begin; bit < end; ++bit)
+    changeLog.bits.push_back(static_cast<uint32_t>(bit));
+}
 
-  if (!candidates.empty()) {
-    int targetIndex = candidates[rand() % candidates.size()];
-    cells[targetIndex].type = CellType::Mine;
-    cells[targetIndex].state = CellState::Hidden;
+void Board::logMovedMines(const std::vector<uint32_t> &cells) {
+  // a moved mine changes its own cell and the counts all around it; cells
+  // are bit index + 1, zero standing for off the board
+  const size_t rowBits = rowWords * 64;
+  for (uint32_t cell : cells) {
+    if (!cell)
+      continue;
+    const int x = static_cast<int>((cell - 1) % rowBits);
+    const int y = static_cast<int>((cell - 1) / rowBits);
+    for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, height - 1); ++ny)
+      for (int nx = std::max(x - 1, 0); nx <= std::min(x + 1, width - 1); ++nx)
+        logChange(static_cast<uint32_t>(bitIndex(nx, ny)));
   }
+}
+
+void Board::restartChangeLog() {
+  // the log never outgrows the limit, so its generations run from base to
+  // base + limit inclusive
+  changeLog.restart(changeLogLimit() + 1);
+}
 
-  calculateNumbers();
+void Board::ChangeLog::restart(uint64_t newSpan) {
+  // a fresh range also strands consumers synced to the current end
+  bits.clear();
+  span = newSpan;
+  base = nextChangeGeneration.fetch_add(span, std::memory_order_relaxed);
 }
@@ -0,0 +1,121 @@
+#include "Minesweeper/Board.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+
+namespace {
+// Planes start one page into the file so the mapped words are aligned.
+constexpr size_t kPlanesOffset = 4096;
+constexpr uint32_t kSnapshotVersion = 1;
+const char kMagic[4] = {'M', 'S', 'S', 'N'};
+
+// Written in native byte order, like the planes themselves.
+struct SnapshotHeader {
+  char magic[4];
+  uint32_t version;
+  int32_t width, height, mineCount;
+  uint8_t safeOpening, firstMove, pad[2];
+  int32_t hiddenSafe, flagsPlaced, minesPlaced, reserved;
+  uint64_t seed;
+  uint64_t rowWords, planeWords;
+  Random rng;
+};
+static_assert(std::is_trivially_copyable<SnapshotHeader>::value &&
+                  sizeof(SnapshotHeader) <= kPlanesOffset,
+              "snapshot header must be plain and fit before the planes");
+
+// Bit indices are 32-bit in the change log and reveal queue, so the padded
+// planes must fit, and every counter must fit the board; the same limits
+// ReplayArchive puts on a replay header.
+bool validCounters(const SnapshotHeader &h) {
+  const uint64_t paddedBits = h.rowWords * 64 * static_cast<uint64_t>(h.height);
+  const int64_t cells = int64_t(h.width) * h.height;
+  auto inBoard = [&](int32_t v) { return v >= 0 && v <= cells; };
+  return paddedBits <= (uint64_t(1) << 32) && inBoard(h.mineCount) &&
+         inBoard(h.minesPlaced) && inBoard(h.flagsPlaced) &&
+         inBoard(h.hiddenSafe) && h.hiddenSafe <= cells - h.minesPlaced;
+}
+} // namespace
+
+bool Board::saveSnapshot(const char *path) const {
+  SnapshotHeader header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kSnapshotVersion;
+  header.width = width;
+  header.height = height;
+  header.mineCount = mineCount;
+  header.safeOpening = safeOpening;
+  header.firstMove = firstMove;
+  header.pad[0] = header.pad[1] = 0;
+  header.hiddenSafe = hiddenSafe;
+  header.flagsPlaced = flagsPlaced;
+  header.minesPlaced = minesPlaced;
+  header.reserved = 0;
+  header.seed = boardSeed;
+  header.rowWords = rowWords;
+  header.planeWords = planeWords;
+  header.rng = rng;
+
+  std::vector<char> page(kPlanesOffset, 0);
+  std::memcpy(page.data(), &header, sizeof(header));
+  // A board loaded from `path` (this one included) still maps its planes
+  // from the file, and truncating it would fault those pages. Write a new
+  // file and rename it over the old one, whose inode the mappings keep.
+  const std::string temp = std::string(path) + ".tmp";
+  FILE *out = std::fopen(temp.c_str(), "wb");
+  if (!out)
+    return false;
+  bool ok = std::fwrite(page.data(), 1, page.size(), out) == page.size() &&
+            std::fwrite(storage.data(), sizeof(uint64_t), storage.size(),
+                        out) == storage.size();
+  ok = std::fclose(out) == 0 && ok && std::rename(temp.c_str(), path) == 0;
+  if (!ok)
+    std::remove(temp.c_str());
+  return ok;
+}
+
+bool Board::loadSnapshot(const char *path) {
+  const int fd = ::open(path, O_RDONLY);
+  if (fd < 0)
+    return false;
+  SnapshotHeader header;
+  struct stat info;
+  bool ok = ::pread(fd, &header, sizeof(header), 0) ==
+                static_cast<ssize_t>(sizeof(header)) &&
+            fstat(fd, &info) == 0;
+  ok = ok && std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+       header.version == kSnapshotVersion && header.width > 0 &&
+       header.height > 0 &&
+       header.rowWords == (static_cast<uint64_t>(header.width) + 63) / 64 &&
+       header.planeWords == header.rowWords * header.height &&
+       validCounters(header);
+  const size_t words = ok ? header.planeWords * PlaneCount : 0;
+  ok = ok && static_cast<uint64_t>(info.st_size) >=
+                 kPlanesOffset + words * sizeof(uint64_t);
+  ok = ok && storage.map(fd, kPlanesOffset, words);
+  ::close(fd); // the mapping keeps the file alive
+  if (!ok)
+    return false;
+
+  width = header.width;
+  height = header.height;
+  mineCount = header.mineCount;
+  safeOpening = header.safeOpening;
+  firstMove = header.firstMove;
+  hiddenSafe = header.hiddenSafe;
+  flagsPlaced = header.flagsPlaced;
+  minesPlaced = header.minesPlaced;
+  boardSeed = header.seed;
+  rowWords = header.rowWords;
+  planeWords = header.planeWords;
+  rng = header.rng;
+  revealQueue.clear();
+  relocations.clear();
+  journal.clear();
+  restartChangeLog();
+  return true;
+}
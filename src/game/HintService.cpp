@@ -0,0 +1,49 @@
+#include "Minesweeper/HintService.h"
+
+HintService::HintService(const Board &board)
+    : board(board), deductions(board), single(1) {
+  onReset();
+}
+
+void HintService::onReset() {
+  deductions.solve();
+  safeCursor = 0;
+  mineCursor = 0;
+}
+
+void HintService::changed(const std::vector<uint32_t> &cells) {
+  deductions.update(cells);
+}
+
+void HintService::onToggleFlag(int x, int y) {
+  if (!board.isFlagged(x, y)) {
+    // the removed flag may have been the premise of earlier deductions
+    onReset();
+    return;
+  }
+  single[0] = static_cast<uint32_t>(board.bitIndex(x, y));
+  changed(single);
+}
+
+bool HintService::advance(const std::vector<uint32_t> &cells, size_t &cursor,
+                          int &outX, int &outY) const {
+  const size_t rowBits = board.wordsPerRow() * 64;
+  for (; cursor < cells.size(); ++cursor) {
+    const int x = static_cast<int>(cells[cursor] % rowBits);
+    const int y = static_cast<int>(cells[cursor] / rowBits);
+    if (!board.isRevealed(x, y) && !board.isFlagged(x, y)) {
+      outX = x;
+      outY = y;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool HintService::nextSafe(int &outX, int &outY) {
+  return advance(deductions.safeCells(), safeCursor, outX, outY);
+}
+
+bool HintService::nextMine(int &outX, int &outY) {
+  return advance(deductions.mineCells(), mineCursor, outX, outY);
+}
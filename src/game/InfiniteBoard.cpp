@@ -0,0 +1,209 @@
+#include "Minesweeper/InfiniteBoard.h"
+#include "Minesweeper/BitOps.h"
+#include "Minesweeper/NeighborCount.h"
+#include "Minesweeper/Random.h"
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+constexpr int kHaloSize = InfiniteBoard::ChunkSize + 2;
+constexpr size_t kHaloWords = 2; // 66 bits per halo row
+
+inline int64_t chunkCoord(int64_t v) { return v >> 6; }
+inline int localCoord(int64_t v) { return static_cast<int>(v & 63); }
+} // namespace
+
+InfiniteBoard::InfiniteBoard(double density, uint64_t seed)
+    : boardSeed(seed),
+      threshold(density >= 1.0   ? ~uint64_t(0)
+                : density <= 0.0 ? 0
+                                 : static_cast<uint64_t>(
+                                       std::ldexp(density, 64))) {}
+
+size_t InfiniteBoard::ChunkKeyHash::operator()(const ChunkKey &key) const {
+  uint64_t state = static_cast<uint64_t>(key.first);
+  uint64_t h = Random::splitmix64(state);
+  state = h ^ static_cast<uint64_t>(key.second);
+  return static_cast<size_t>(Random::splitmix64(state));
+}
+
+bool InfiniteBoard::hashMine(int64_t x, int64_t y) const {
+  if (!firstMove && std::llabs(x - safeX) <= 1 && std::llabs(y - safeY) <= 1)
+    return false;
+  uint64_t state = boardSeed ^ static_cast<uint64_t>(x);
+  uint64_t h = Random::splitmix64(state);
+  state = h ^ static_cast<uint64_t>(y);
+  return Random::splitmix64(state) < threshold;
+}
+
+void InfiniteBoard::buildChunk(Chunk &chunk, int64_t cx, int64_t cy) const {
+  // Sample a 66x66 window (the chunk plus a one-cell halo taken straight from
+  // the hash) and run the shared bit-sliced kernel over it.
+  uint64_t window[kHaloSize * kHaloWords] = {};
+  const int64_t originX = cx * ChunkSize - 1;
+  const int64_t originY = cy * ChunkSize - 1;
+  for (int wy = 0; wy < kHaloSize; ++wy)
+    for (int wx = 0; wx < kHaloSize; ++wx)
+      if (hashMine(originX + wx, originY + wy))
+        setBit(window, wy * kHaloWords * 64 + wx);
+
+  uint64_t counts[4][kHaloSize * kHaloWords];
+  uint64_t *const countPtrs[4] = {counts[0], counts[1], counts[2], counts[3]};
+  countNeighborsBitSliced(window, kHaloWords, kHaloSize, kHaloSize, countPtrs,
+                          1, kHaloSize - 1);
+
+  auto inner = [](const uint64_t *rows, int wy) {
+    return (rows[wy * kHaloWords] >> 1) | (rows[wy * kHaloWords + 1] << 63);
+  };
+  for (int y = 0; y < ChunkSize; ++y) {
+    chunk.mines[y] = inner(window, y + 1);
+    for (int k = 0; k < 4; ++k)
+      chunk.counts[k][y] = inner(counts[k], y + 1);
+  }
+}
+
+const InfiniteBoard::Chunk *InfiniteBoard::findChunk(int64_t x,
+                                                     int64_t y) const {
+  auto it = chunks.find(chunkKey(chunkCoord(x), chunkCoord(y)));
+  return it == chunks.end() ? nullptr : &it->second;
+}
+
+InfiniteBoard::Chunk &InfiniteBoard::touchChunk(int64_t x, int64_t y) {
+  const int64_t cx = chunkCoord(x), cy = chunkCoord(y);
+  auto inserted = chunks.try_emplace(chunkKey(cx, cy));
+  if (inserted.second)
+    buildChunk(inserted.first->second, cx, cy);
+  return inserted.first->second;
+}
+
+bool InfiniteBoard::isMine(int64_t x, int64_t y) const {
+  if (const Chunk *chunk = findChunk(x, y))
+    return (chunk->mines[localCoord(y)] >> localCoord(x)) & 1u;
+  return hashMine(x, y);
+}
+
+int InfiniteBoard::neighborCount(int64_t x, int64_t y) const {
+  if (const Chunk *chunk = findChunk(x, y)) {
+    int count = 0;
+    for (int k = 0; k < 4; ++k)
+      count |= static_cast<int>((chunk->counts[k][localCoord(y)] >>
+                                 localCoord(x)) & 1u)
+               << k;
+    return count;
+  }
+  if (hashMine(x, y))
+    return 0;
+  int count = 0;
+  for (int dy = -1; dy <= 1; ++dy)
+    for (int dx = -1; dx <= 1; ++dx)
+      if ((dx || dy) && hashMine(x + dx, y + dy))
+        count++;
+  return count;
+}
+
+Cell InfiniteBoard::get(int64_t x, int64_t y) const {
+  Cell cell;
+  cell.type = isMine(x, y) ? CellType::Mine : CellType::Empty;
+  cell.neighborMines = neighborCount(x, y);
+  if (const Chunk *chunk = findChunk(x, y)) {
+    const int lx = localCoord(x), ly = localCoord(y);
+    if ((chunk->revealed[ly] >> lx) & 1u)
+      cell.state = CellState::Revealed;
+    else if ((chunk->flagged[ly] >> lx) & 1u)
+      cell.state = CellState::Flagged;
+  }
+  return cell;
+}
+
+void InfiniteBoard::toggleFlag(int64_t x, int64_t y) {
+  Chunk &chunk = touchChunk(x, y);
+  const int lx = localCoord(x), ly = localCoord(y);
+  if ((chunk.revealed[ly] >> lx) & 1u)
+    return;
+  const bool wasFlagged = (chunk.flagged[ly] >> lx) & 1u;
+  chunk.flagged[ly] ^= uint64_t(1) << lx;
+  chunk.touched += wasFlagged ? -1 : 1;
+  flaggedCells += wasFlagged ? -1 : 1;
+}
+
+bool InfiniteBoard::reveal(int64_t x, int64_t y) {
+  revealQueue.clear();
+
+  if (firstMove) {
+    // The first reveal is always safe: carve a mine-free 3x3 opening and
+    // rebuild any chunk whose mines or counts it changes.
+    firstMove = false;
+    safeX = x;
+    safeY = y;
+    for (int64_t cy = chunkCoord(y - 2); cy <= chunkCoord(y + 2); ++cy)
+      for (int64_t cx = chunkCoord(x - 2); cx <= chunkCoord(x + 2); ++cx) {
+        auto it = chunks.find(chunkKey(cx, cy));
+        if (it != chunks.end())
+          buildChunk(it->second, cx, cy);
+      }
+  }
+
+  Chunk *chunk = &touchChunk(x, y);
+  int lx = localCoord(x), ly = localCoord(y);
+  if (((chunk->revealed[ly] | chunk->flagged[ly]) >> lx) & 1u)
+    return false;
+
+  chunk->revealed[ly] |= uint64_t(1) << lx;
+  chunk->touched++;
+  revealQueue.emplace_back(x, y);
+  if ((chunk->mines[ly] >> lx) & 1u)
+    return true;
+
+  int64_t cachedCx = chunkCoord(x), cachedCy = chunkCoord(y);
+  auto chunkFor = [&](int64_t px, int64_t py) -> Chunk & {
+    if (chunkCoord(px) != cachedCx || chunkCoord(py) != cachedCy) {
+      cachedCx = chunkCoord(px);
+      cachedCy = chunkCoord(py);
+      chunk = &touchChunk(px, py);
+    }
+    return *chunk;
+  };
+
+  for (size_t head = 0; head < revealQueue.size(); ++head) {
+    const int64_t cx = revealQueue[head].first;
+    const int64_t cy = revealQueue[head].second;
+    Chunk &cur = chunkFor(cx, cy);
+    lx = localCoord(cx);
+    ly = localCoord(cy);
+    if (((cur.counts[0][ly] | cur.counts[1][ly] | cur.counts[2][ly] |
+          cur.counts[3][ly]) >>
+         lx) &
+        1u)
+      continue;
+
+    for (int dy = -1; dy <= 1; ++dy)
+      for (int dx = -1; dx <= 1; ++dx) {
+        if ((!dx && !dy) || revealQueue.size() >= revealLimit)
+          continue;
+        const int64_t nx = cx + dx, ny = cy + dy;
+        Chunk &next = chunkFor(nx, ny);
+        const int nlx = localCoord(nx), nly = localCoord(ny);
+        if (((next.revealed[nly] | next.flagged[nly]) >> nlx) & 1u)
+          continue;
+        next.revealed[nly] |= uint64_t(1) << nlx;
+        next.touched++;
+        revealQueue.emplace_back(nx, ny);
+      }
+  }
+
+  revealedCells += revealQueue.size();
+  return false;
+}
+
+size_t InfiniteBoard::evictUntouched() {
+  size_t released = 0;
+  for (auto it = chunks.begin(); it != chunks.end();) {
+    if (it->second.touched == 0) {
+      it = chunks.erase(it);
+      ++released;
+    } else {
+      ++it;
+    }
+  }
+  return released;
+}
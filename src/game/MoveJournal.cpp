@@ -0,0 +1,111 @@
+#include "Minesweeper/MoveJournal.h"
+#include <algorithm>
+
+namespace {
+size_t varintSize(uint64_t value) {
+  size_t size = 1;
+  while (value >= 0x80) {
+    value >>= 7;
+    ++size;
+  }
+  return size;
+}
+} // namespace
+
+void MoveJournal::SpanWriter::addRun(size_t begin, size_t end) {
+  if (!runs.empty() && runs.back() == begin)
+    runs.back() = end;
+  else {
+    runs.push_back(begin);
+    runs.push_back(end);
+  }
+}
+
+void MoveJournal::SpanWriter::addWord(size_t wordIndex, uint64_t mask) {
+  const size_t base = wordIndex * 64;
+  while (mask) {
+    const int begin = __builtin_ctzll(mask);
+    const uint64_t rest = ~(mask >> begin);
+    const int length = rest ? __builtin_ctzll(rest) : 64 - begin;
+    addRun(base + begin, base + begin + length);
+    if (begin + length >= 64)
+      break;
+    mask &= ~uint64_t(0) << (begin + length);
+  }
+}
+
+void MoveJournal::SpanWriter::write(std::vector<uint8_t> &out) const {
+  putVarint(out, runs.size() / 2);
+  size_t last = 0;
+  for (size_t i = 0; i < runs.size(); i += 2) {
+    putVarint(out, runs[i] - last);
+    putVarint(out, runs[i + 1] - runs[i]);
+    last = runs[i + 1];
+  }
+}
+
+void MoveJournal::append(const std::vector<uint8_t> &payload) {
+  data.resize(cursor);
+  putVarint(data, payload.size());
+  data.insert(data.end(), payload.begin(), payload.end());
+  const size_t trailer = data.size();
+  putVarint(data, payload.size());
+  std::reverse(data.begin() + trailer, data.end());
+  cursor = data.size();
+  trim();
+}
+
+MoveJournal::Reader MoveJournal::undo() {
+  // the trailer is the length varint stored back to front
+  size_t pos = cursor;
+  uint64_t length = 0;
+  for (int shift = 0;; shift += 7) {
+    const uint8_t b = data[--pos];
+    length |= uint64_t(b & 0x7f) << shift;
+    if (!(b & 0x80))
+      break;
+  }
+  Reader reader;
+  reader.end = data.data() + pos;
+  reader.pos = reader.end - length;
+  cursor = pos - length - varintSize(length);
+  return reader;
+}
+
+MoveJournal::Reader MoveJournal::redo() {
+  Reader reader;
+  reader.pos = data.data() + cursor;
+  const uint64_t length = reader.varint();
+  reader.end = reader.pos + length;
+  cursor = (reader.end - data.data()) + varintSize(length);
+  return reader;
+}
+
+void MoveJournal::clear() {
+  data.clear();
+  head = cursor = 0;
+}
+
+void MoveJournal::setBudget(size_t bytes) {
+  budgetBytes = bytes;
+  trim();
+}
+
+void MoveJournal::trim() {
+  while (bytesUsed() > budgetBytes) {
+    Reader first;
+    first.pos = data.data() + head;
+    const uint64_t length = first.varint();
+    const size_t next =
+        (first.pos - data.data()) + length + varintSize(length);
+    if (next >= cursor)
+      break; // keep the newest undoable record
+    head = next;
+  }
+  // compact once the dropped prefix dominates, keeping trims amortized O(1)
+  if (head > 4096 && head * 2 > data.size()) {
+    data.erase(data.begin(), data.begin() + head);
+    cursor -= head;
+    head = 0;
+  }
+}
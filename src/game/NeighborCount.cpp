@@ -0,0 +1,165 @@
+#include "Minesweeper/NeighborCount.h"
+#include "Minesweeper/BitOps.h"
+
+namespace {
+// Per-word view of one row: the cells themselves plus their west and east
+// neighbors shifted into the same bit positions.
+struct RowTaps {
+  uint64_t west = 0, center = 0, east = 0;
+};
+
+inline RowTaps loadRow(const uint64_t *row, size_t w, size_t rowWords) {
+  RowTaps t;
+  if (!row)
+    return t;
+  uint64_t prev = w > 0 ? row[w - 1] : 0;
+  uint64_t next = w + 1 < rowWords ? row[w + 1] : 0;
+  t.center = row[w];
+  t.west = (t.center << 1) | (prev >> 63);
+  t.east = (t.center >> 1) | (next << 63);
+  return t;
+}
+
+inline void fullAdd(uint64_t a, uint64_t b, uint64_t c, uint64_t &sum,
+                    uint64_t &carry) {
+  uint64_t ab = a ^ b;
+  sum = ab ^ c;
+  carry = (a & b) | (ab & c);
+}
+} // namespace
+
+void countNeighborsBitSliced(const uint64_t *mines, size_t rowWords, int width,
+                             int height, uint64_t *const counts[4],
+                             int rowBegin, int rowEnd) {
+  const uint64_t tailMask = rowTailMask(width);
+
+  for (int y = rowBegin; y < rowEnd; ++y) {
+    const uint64_t *above = y > 0 ? mines + (y - 1) * rowWords : nullptr;
+    const uint64_t *row = mines + y * rowWords;
+    const uint64_t *below = y + 1 < height ? mines + (y + 1) * rowWords
+                                           : nullptr;
+
+    for (size_t w = 0; w < rowWords; ++w) {
+      RowTaps a = loadRow(above, w, rowWords);
+      RowTaps m = loadRow(row, w, rowWords);
+      RowTaps b = loadRow(below, w, rowWords);
+
+      // Adder tree over the eight neighbor bits.
+      uint64_t s1, c1, s2, c2, s3, c3;
+      fullAdd(a.west, a.center, a.east, s1, c1);
+      fullAdd(b.west, b.center, b.east, s2, c2);
+      s3 = m.west ^ m.east;
+      c3 = m.west & m.east;
+
+      uint64_t bit0, d;
+      fullAdd(s1, s2, s3, bit0, d);
+      uint64_t e, f;
+      fullAdd(c1, c2, c3, e, f);
+      uint64_t bit1 = e ^ d;
+      uint64_t g = e & d;
+      uint64_t bit2 = f ^ g;
+      uint64_t bit3 = f & g;
+
+      uint64_t keep = ~m.center;
+      if (w + 1 == rowWords)
+        keep &= tailMask;
+
+      const size_t idx = y * rowWords + w;
+      counts[0][idx] = bit0 & keep;
+      counts[1][idx] = bit1 & keep;
+      counts[2][idx] = bit2 & keep;
+      counts[3][idx] = bit3 & keep;
+    }
+  }
+}
+
+void countNeighborsScalar(const uint64_t *mines, size_t rowWords, int width,
+                          int height, uint64_t *const counts[4], int rowBegin,
+                          int rowEnd) {
+  const size_t rowBits = rowWords * 64;
+  for (int y = rowBegin; y < rowEnd; ++y) {
+    for (size_t w = 0; w < rowWords; ++w)
+      for (int k = 0; k < 4; ++k)
+        counts[k][y * rowWords + w] = 0;
+
+    for (int x = 0; x < width; ++x) {
+      const size_t bit = y * rowBits + x;
+      if (testBit(mines, bit))
+        continue;
+
+      int count = 0;
+      for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+          int nx = x + dx;
+          int ny = y + dy;
+          if (nx >= 0 && nx < width && ny >= 0 && ny < height &&
+              testBit(mines, ny * rowBits + nx))
+            count++;
+        }
+      }
+      for (int k = 0; k < 4; ++k)
+        if ((count >> k) & 1)
+          setBit(counts[k], bit);
+    }
+  }
+}
+
+namespace {
+// Adds a one-bit-per-cell vector into a bit-sliced accumulator at the given
+// weight, rippling carries upward.
+inline void accumulate(uint64_t *acc, int planes, int weight, uint64_t v) {
+  for (int k = weight; k < planes && v; ++k) {
+    uint64_t carry = acc[k] & v;
+    acc[k] ^= v;
+    v = carry;
+  }
+}
+} // namespace
+
+void countNeighbors26BitSliced(const uint64_t *mines, size_t rowWords,
+                               int width, int height, int depth,
+                               uint64_t *const counts[5], int zBegin,
+                               int zEnd) {
+  const uint64_t tailMask = rowTailMask(width);
+
+  for (int z = zBegin; z < zEnd; ++z) {
+    for (int y = 0; y < height; ++y) {
+      const uint64_t *rows[9];
+      for (int dz = -1; dz <= 1; ++dz)
+        for (int dy = -1; dy <= 1; ++dy) {
+          int nz = z + dz, ny = y + dy;
+          bool inside = nz >= 0 && nz < depth && ny >= 0 && ny < height;
+          rows[(dz + 1) * 3 + (dy + 1)] =
+              inside ? mines + (static_cast<size_t>(nz) * height + ny) *
+                                   rowWords
+                     : nullptr;
+        }
+
+      const size_t rowBase = (static_cast<size_t>(z) * height + y) * rowWords;
+      for (size_t w = 0; w < rowWords; ++w) {
+        uint64_t acc[5] = {};
+        uint64_t self = 0;
+        for (int r = 0; r < 9; ++r) {
+          RowTaps t = loadRow(rows[r], w, rowWords);
+          if (r == 4) {
+            // the cell's own row: west and east only
+            self = t.center;
+            accumulate(acc, 5, 0, t.west ^ t.east);
+            accumulate(acc, 5, 1, t.west & t.east);
+          } else {
+            uint64_t sum, carry;
+            fullAdd(t.west, t.center, t.east, sum, carry);
+            accumulate(acc, 5, 0, sum);
+            accumulate(acc, 5, 1, carry);
+          }
+        }
+
+        uint64_t keep = ~self;
+        if (w + 1 == rowWords)
+          keep &= tailMask;
+        for (int k = 0; k < 5; ++k)
+          counts[k][rowBase + w] = acc[k] & keep;
+      }
+    }
+  }
+}
@@ -0,0 +1,64 @@
+#include "Minesweeper/NoGuess.h"
+#include "Minesweeper/Random.h"
+#include "Minesweeper/Solver.h"
+#include <atomic>
+#include <climits>
+
+namespace {
+uint64_t candidateSeed(uint64_t base, int attempt) {
+  uint64_t state = base + static_cast<uint64_t>(attempt);
+  return Random::splitmix64(state);
+}
+} // namespace
+
+bool generateNoGuess(Board &board, int firstX, int firstY, int maxAttempts,
+                     ThreadPool &pool) {
+  const uint64_t base = board.seed();
+  std::atomic<int> next{0};
+  std::atomic<int> best{INT_MAX};
+
+  pool.parallelFor(pool.size() + 1, [&](size_t) {
+    // every attempt resets with its own seed, so start from an empty board
+    // rather than generating a layout that is thrown away
+    Board candidate(board.width, board.height, 0, base);
+    candidate.mineCount = board.mineCount;
+    candidate.safeOpening = true;
+    Solver solver(candidate);
+
+    while (true) {
+      const int attempt = next.fetch_add(1);
+      if (attempt >= maxAttempts || attempt > best.load())
+        return;
+
+      candidate.reset(candidateSeed(base, attempt));
+      candidate.reveal(firstX, firstY);
+      bool abandoned = false;
+      while (!candidate.checkWin()) {
+        if (attempt > best.load()) {
+          abandoned = true;
+          break;
+        }
+        solver.solve();
+        if (solver.safeCells().empty())
+          break;
+        const size_t rowBits = candidate.wordsPerRow() * 64;
+        for (uint32_t bit : solver.safeCells())
+          candidate.reveal(static_cast<int>(bit % rowBits),
+                           static_cast<int>(bit / rowBits));
+      }
+      if (abandoned || !candidate.checkWin())
+        continue;
+
+      int current = best.load();
+      while (attempt < current && !best.compare_exchange_weak(current, attempt))
+        ;
+      return;
+    }
+  });
+
+  if (best.load() == INT_MAX)
+    return false;
+  board.safeOpening = true;
+  board.reset(candidateSeed(base, best.load()));
+  return true;
+}
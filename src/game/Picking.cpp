@@ -0,0 +1,52 @@
+#include "Minesweeper/Picking.h"
+#include <algorithm>
+
+glm::vec3 gridCenter(int x, int y, const Board &board) {
+  // Center grid precisely: use (dim-1)/2.0f, not integer dim/2
+  float gx = (x - (board.width - 1) * 0.5f) * kTileSpacing;
+  float gy = (y - (board.height - 1) * 0.5f) * kTileSpacing;
+  return glm::vec3(gx, gy, 0.0f);
+}
+
+bool pickTile(const Board &board, const glm::vec3 &origin,
+              const glm::vec3 &direction, float maxDistance, int &outX,
+              int &outY) {
+  const float invDirX = (direction.x != 0.0f) ? 1.0f / direction.x : 1e6f;
+  const float invDirY = (direction.y != 0.0f) ? 1.0f / direction.y : 1e6f;
+  const float invDirZ = (direction.z != 0.0f) ? 1.0f / direction.z : 1e6f;
+
+  int hitX = -1, hitY = -1;
+  float minDist = 1e9f;
+  for (int x = 0; x < board.width; ++x) {
+    for (int y = 0; y < board.height; ++y) {
+      glm::vec3 c = gridCenter(x, y, board);
+      glm::vec3 minB = c - glm::vec3(0.5f);
+      glm::vec3 maxB = c + glm::vec3(0.5f);
+
+      float t1 = (minB.x - origin.x) * invDirX;
+      float t2 = (maxB.x - origin.x) * invDirX;
+      float t3 = (minB.y - origin.y) * invDirY;
+      float t4 = (maxB.y - origin.y) * invDirY;
+      float t5 = (minB.z - origin.z) * invDirZ;
+      float t6 = (maxB.z - origin.z) * invDirZ;
+
+      float tmin =
+          std::max({std::min(t1, t2), std::min(t3, t4), std::min(t5, t6)});
+      float tmax =
+          std::min({std::max(t1, t2), std::max(t3, t4), std::max(t5, t6)});
+
+      if (tmax >= std::max(0.0f, tmin) && tmin < minDist &&
+          tmin < maxDistance) {
+        minDist = tmin;
+        hitX = x;
+        hitY = y;
+      }
+    }
+  }
+
+  if (hitX < 0)
+    return false;
+  outX = hitX;
+  outY = hitY;
+  return true;
+}
@@ -0,0 +1,63 @@
+#include "Minesweeper/PlaneStorage.h"
+#include <algorithm>
+#include <sys/mman.h>
+
+PlaneStorage::PlaneStorage(const PlaneStorage &other)
+    : owned(other.words, other.words + other.count), words(owned.data()),
+      count(other.count) {}
+
+PlaneStorage &PlaneStorage::operator=(const PlaneStorage &other) {
+  if (this != &other) {
+    std::vector<uint64_t> copy(other.words, other.words + other.count);
+    unmap();
+    owned.swap(copy);
+    words = owned.data();
+    count = other.count;
+  }
+  return *this;
+}
+
+PlaneStorage &PlaneStorage::operator=(PlaneStorage &&other) noexcept {
+  if (this != &other) {
+    unmap();
+    owned = std::move(other.owned);
+    mapBase = other.mapBase;
+    mapBytes = other.mapBytes;
+    words = mapBase ? other.words : owned.data();
+    count = other.count;
+    other.mapBase = nullptr;
+    other.mapBytes = 0;
+    other.words = nullptr;
+    other.count = 0;
+  }
+  return *this;
+}
+
+void PlaneStorage::assign(size_t newWords) {
+  unmap();
+  owned.assign(newWords, 0);
+  words = owned.data();
+  count = newWords;
+}
+
+bool PlaneStorage::map(int fd, size_t offset, size_t newWords) {
+  const size_t bytes = offset + newWords * sizeof(uint64_t);
+  void *base =
+      mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  if (base == MAP_FAILED)
+    return false;
+  unmap();
+  std::vector<uint64_t>().swap(owned);
+  mapBase = base;
+  mapBytes = bytes;
+  words = reinterpret_cast<uint64_t *>(static_cast<char *>(base) + offset);
+  count = newWords;
+  return true;
+}
+
+void PlaneStorage::unmap() {
+  if (mapBase)
+    munmap(mapBase, mapBytes);
+  mapBase = nullptr;
+  mapBytes = 0;
+}
@@ -0,0 +1,491 @@
+#include "Minesweeper/ProbabilityEngine.h"
+#include "Minesweeper/BitOps.h"
+#include "Minesweeper/ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// Components larger than this are estimated without trying to enumerate.
+constexpr size_t kMaxEnumeratedCells = 512;
+// Exact combination costs O(span^2) in the summed mine-count ranges; wider
+// frontiers use a mean-field weighting instead.
+constexpr int kExactSpan = 1024;
+constexpr size_t kCacheLimit = 4096;
+constexpr uint32_t kDeadlineStride = 4096;
+
+class Enumerator {
+public:
+  Enumerator(const ProbabilityEngine::Component &component,
+             ProbabilityEngine::Distribution &out, Clock::time_point deadline)
+      : comp(component), out(out), deadline(deadline),
+        remainingNeeded(component.needed), value(component.cells.size()) {
+    const size_t n = comp.cells.size();
+    out.fewestMines = 0;
+    out.solutions.assign(n + 1, 0.0);
+    out.cellMines.assign((n + 1) * n, 0.0);
+    remainingCells.reserve(comp.constraintCells.size());
+    for (const ProbabilityEngine::Links &cells : comp.constraintCells)
+      remainingCells.push_back(cells.count);
+  }
+
+  // Returns false if the deadline passed before every branch was visited.
+  bool run() {
+    for (size_t j = 0; j < remainingNeeded.size(); ++j)
+      if (remainingNeeded[j] < 0 || remainingNeeded[j] > remainingCells[j])
+        return true; // inconsistent constraint: no solutions
+    assign(0);
+    return !expired;
+  }
+
+private:
+  const ProbabilityEngine::Component &comp;
+  ProbabilityEngine::Distribution &out;
+  Clock::time_point deadline;
+  std::vector<int> remainingNeeded;
+  std::vector<int> remainingCells;
+  std::vector<char> value;
+  int mines = 0;
+  uint32_t steps = 0;
+  bool expired = false;
+
+  bool apply(size_t i, int v) {
+    bool feasible = true;
+    for (int j : comp.cellConstraints[i]) {
+      remainingCells[j]--;
+      remainingNeeded[j] -= v;
+      feasible &= remainingNeeded[j] >= 0 &&
+                  remainingNeeded[j] <= remainingCells[j];
+    }
+    return feasible;
+  }
+
+  void undo(size_t i, int v) {
+    for (int j : comp.cellConstraints[i]) {
+      remainingCells[j]++;
+      remainingNeeded[j] += v;
+    }
+  }
+
+  void assign(size_t i) {
+    if (expired)
+      return;
+    if (++steps % kDeadlineStride == 0 && Clock::now() >= deadline) {
+      expired = true;
+      return;
+    }
+    const size_t n = comp.cells.size();
+    if (i == n) {
+      out.solutions[mines] += 1.0;
+      double *row = out.cellMines.data() + static_cast<size_t>(mines) * n;
+      for (size_t c = 0; c < n; ++c)
+        row[c] += value[c];
+      return;
+    }
+    for (int v = 0; v <= 1; ++v) {
+      if (apply(i, v)) {
+        value[i] = static_cast<char>(v);
+        mines += v;
+        assign(i + 1);
+        mines -= v;
+        value[i] = 0;
+      }
+      undo(i, v);
+    }
+  }
+};
+
+// Stand-in for a component that could not be enumerated in time: each cell
+// gets the highest local density among its constraints, lumped into a
+// single mine count.
+void estimate(const ProbabilityEngine::Component &comp,
+              ProbabilityEngine::Distribution &out) {
+  const size_t n = comp.cells.size();
+  std::vector<double> p(n, 0.0);
+  double expected = 0.0;
+  for (size_t i = 0; i < n; ++i) {
+    for (int j : comp.cellConstraints[i])
+      p[i] = std::max(p[i], double(comp.needed[j]) /
+                                comp.constraintCells[j].count);
+    p[i] = std::min(std::max(p[i], 0.0), 1.0);
+    expected += p[i];
+  }
+  out.fewestMines = std::min(static_cast<int>(n),
+                             static_cast<int>(std::lround(expected)));
+  out.solutions.assign(1, 1.0);
+  out.cellMines = std::move(p);
+}
+
+double logBinomial(int n, int k) {
+  if (k < 0 || k > n)
+    return -std::numeric_limits<double>::infinity();
+  return std::lgamma(n + 1.0) - std::lgamma(k + 1.0) -
+         std::lgamma(n - k + 1.0);
+}
+
+void rescale(std::vector<double> &values) {
+  const double peak = *std::max_element(values.begin(), values.end());
+  if (peak > 0.0)
+    for (double &v : values)
+      v /= peak;
+}
+} // namespace
+
+ProbabilityEngine::ProbabilityEngine(const Board &board)
+    : board(board),
+      probs(static_cast<size_t>(board.width) * board.height, 0.0f),
+      frontierId(board.wordsPerPlane() * 64, -1) {}
+
+bool ProbabilityEngine::safestCell(int &outX, int &outY) const {
+  const uint64_t *revealed = board.plane(Board::RevealedPlane);
+  const uint64_t *flagged = board.plane(Board::FlaggedPlane);
+  float best = 2.0f;
+  for (int y = 0; y < board.height; ++y)
+    for (int x = 0; x < board.width; ++x) {
+      const size_t bit = board.bitIndex(x, y);
+      if (testBit(revealed, bit) || testBit(flagged, bit))
+        continue;
+      const float p = mineProbability(x, y);
+      if (p < best) {
+        best = p;
+        outX = x;
+        outY = y;
+      }
+    }
+  return best <= 1.0f;
+}
+
+bool ProbabilityEngine::compute(std::chrono::microseconds budget) {
+  const Clock::time_point deadline = Clock::now() + budget;
+  exactResult = true;
+
+  int unknownCells = 0;
+  buildComponents(unknownCells);
+
+  std::vector<Distribution> dists(components.size());
+  std::vector<size_t> pending;
+  for (size_t c = 0; c < components.size(); ++c) {
+    auto it = cache.find(components[c].key);
+    if (it != cache.end())
+      dists[c] = it->second;
+    else
+      pending.push_back(c);
+  }
+
+  std::vector<char> finished(pending.size(), 0);
+  ThreadPool::shared().parallelFor(pending.size(), [&](size_t p) {
+    const size_t c = pending[p];
+    if (components[c].cells.size() > kMaxEnumeratedCells)
+      return;
+    finished[p] = Enumerator(components[c], dists[c], deadline).run();
+  });
+
+  if (cache.size() + pending.size() > kCacheLimit)
+    cache.clear();
+  for (size_t p = 0; p < pending.size(); ++p) {
+    const size_t c = pending[p];
+    if (finished[p]) {
+      cache.emplace(components[c].key, dists[c]);
+    } else {
+      estimate(components[c], dists[c]);
+      exactResult = false;
+    }
+  }
+
+  combine(dists, unknownCells);
+  return exactResult;
+}
+
+void ProbabilityEngine::buildComponents(int &unknownCells) {
+  // Constraints are revealed safe cells with at least one hidden unflagged
+  // neighbor: revealed & ~mine & dilate(unknown), a word at a time.
+  const uint64_t *revealed = board.plane(Board::RevealedPlane);
+  const uint64_t *flagged = board.plane(Board::FlaggedPlane);
+  const uint64_t *mineBits = board.plane(Board::MinePlane);
+  const size_t rowWords = board.wordsPerRow();
+  const uint64_t tailMask = rowTailMask(board.width);
+  auto unknownWord = [&](int y, long w) -> uint64_t {
+    if (y < 0 || y >= board.height || w < 0 || w >= long(rowWords))
+      return 0;
+    const size_t idx = y * rowWords + w;
+    uint64_t valid = (size_t(w) + 1 == rowWords) ? tailMask : ~uint64_t(0);
+    return ~(revealed[idx] | flagged[idx]) & valid;
+  };
+
+  std::vector<uint32_t> frontier;
+  std::vector<int> constraintNeeded;
+  std::vector<Links> constraintCells;
+  unknownCells = 0;
+  for (int y = 0; y < board.height; ++y) {
+    for (size_t w = 0; w < rowWords; ++w) {
+      uint64_t near = 0;
+      for (int dy = -1; dy <= 1; ++dy) {
+        uint64_t c = unknownWord(y + dy, long(w));
+        uint64_t prev = unknownWord(y + dy, long(w) - 1);
+        uint64_t next = unknownWord(y + dy, long(w) + 1);
+        near |= c | (c << 1) | (prev >> 63) | (c >> 1) | (next << 63);
+      }
+      unknownCells += popcount64(unknownWord(y, long(w)));
+      const size_t idx = y * rowWords + w;
+      uint64_t pending = revealed[idx] & ~mineBits[idx] & near;
+      while (pending) {
+        const int x = static_cast<int>(w * 64) + countTrailingZeros64(pending);
+        pending &= pending - 1;
+        int needed = board.neighborCount(x, y);
+        Links cells;
+        for (int ny = y - 1; ny <= y + 1; ++ny)
+          for (int nx = x - 1; nx <= x + 1; ++nx) {
+            if (nx < 0 || nx >= board.width || ny < 0 || ny >= board.height)
+              continue;
+            const size_t bit = board.bitIndex(nx, ny);
+            if (testBit(revealed, bit))
+              continue;
+            if (testBit(flagged, bit)) {
+              needed--;
+              continue;
+            }
+            if (frontierId[bit] < 0) {
+              frontierId[bit] = static_cast<int>(frontier.size());
+              frontier.push_back(static_cast<uint32_t>(bit));
+            }
+            cells.push(frontierId[bit]);
+          }
+        constraintNeeded.push_back(needed);
+        constraintCells.push_back(cells);
+      }
+    }
+  }
+
+  std::vector<Links> cellConstraints(frontier.size());
+  for (size_t j = 0; j < constraintCells.size(); ++j)
+    for (int cell : constraintCells[j])
+      cellConstraints[cell].push(static_cast<int>(j));
+
+  // Breadth-first walks over the cell/constraint graph find the components
+  // and give each one an enumeration order in which constraints close early.
+  components.clear();
+  std::vector<int> localCell(frontier.size(), -1);
+  std::vector<int> localConstraint(constraintCells.size(), -1);
+  for (size_t start = 0; start < frontier.size(); ++start) {
+    if (localCell[start] >= 0)
+      continue;
+    components.emplace_back();
+    Component &comp = components.back();
+    std::vector<int> order{static_cast<int>(start)};
+    localCell[start] = 0;
+    for (size_t head = 0; head < order.size(); ++head) {
+      for (int j : cellConstraints[order[head]]) {
+        if (localConstraint[j] >= 0)
+          continue;
+        localConstraint[j] = static_cast<int>(comp.needed.size());
+        comp.needed.push_back(constraintNeeded[j]);
+        comp.constraintCells.emplace_back();
+        for (int cell : constraintCells[j]) {
+          if (localCell[cell] < 0) {
+            localCell[cell] = static_cast<int>(order.size());
+            order.push_back(cell);
+          }
+          comp.constraintCells.back().push(localCell[cell]);
+        }
+      }
+    }
+
+    comp.cellConstraints.resize(order.size());
+    comp.key.push_back(static_cast<uint32_t>(order.size()));
+    for (size_t j = 0; j < comp.constraintCells.size(); ++j) {
+      comp.key.push_back(static_cast<uint32_t>(comp.needed[j]));
+      comp.key.push_back(static_cast<uint32_t>(comp.constraintCells[j].count));
+      for (int cell : comp.constraintCells[j]) {
+        comp.cellConstraints[cell].push(static_cast<int>(j));
+        comp.key.push_back(static_cast<uint32_t>(cell));
+      }
+    }
+    for (int cell : order)
+      comp.cells.push_back(frontier[cell]);
+  }
+
+  for (uint32_t bit : frontier)
+    frontierId[bit] = -1;
+}
+
+void ProbabilityEngine::fillUniform(float probability) {
+  const uint64_t *revealed = board.plane(Board::RevealedPlane);
+  const uint64_t *flagged = board.plane(Board::FlaggedPlane);
+  float *out = probs.data();
+  for (int y = 0; y < board.height; ++y)
+    for (int x = 0; x < board.width; ++x) {
+      const size_t bit = board.bitIndex(x, y);
+      *out++ = testBit(revealed, bit)  ? 0.0f
+               : testBit(flagged, bit) ? 1.0f
+                                       : probability;
+    }
+}
+
+void ProbabilityEngine::combine(std::vector<Distribution> &dists,
+                                int unknownCells) {
+  const int minesLeft = board.minesRemaining();
+  int frontierCells = 0;
+  for (const Component &comp : components)
+    frontierCells += static_cast<int>(comp.cells.size());
+  const int others = unknownCells - frontierCells;
+  auto inconsistent = [&] {
+    exactResult = false;
+    fillUniform(unknownCells > 0 ? std::min(std::max(float(minesLeft) /
+                                                         unknownCells,
+                                                     0.0f),
+                                            1.0f)
+                                 : 0.0f);
+  };
+
+  // Trim every component to the mine counts it can actually hold and scale
+  // its counts to at most 1; each posterior is normalized on its own, so
+  // the scale factors cancel.
+  const size_t count = components.size();
+  std::vector<int> lo(count), span(count);
+  std::vector<std::vector<double>> weights(count);
+  int base = 0, totalSpan = 0;
+  for (size_t c = 0; c < count; ++c) {
+    const std::vector<double> &solutions = dists[c].solutions;
+    int first = -1, last = -1;
+    for (int k = 0; k < int(solutions.size()); ++k)
+      if (solutions[k] > 0.0) {
+        if (first < 0)
+          first = k;
+        last = k;
+      }
+    if (first < 0)
+      return inconsistent();
+    lo[c] = dists[c].fewestMines + first;
+    span[c] = last - first;
+    weights[c].assign(solutions.begin() + first, solutions.begin() + last + 1);
+    rescale(weights[c]);
+    base += first;
+    totalSpan += span[c];
+  }
+
+  auto logWeight = [&](int frontierMines) {
+    return logBinomial(others, minesLeft - frontierMines);
+  };
+  double otherProbability = 0.0;
+
+  if (totalSpan <= kExactSpan) {
+    // w[j]: weight of base + j frontier mines. Backward tables B_i[j] hold
+    // the weighted configuration count of components i.. given j mines in
+    // the ones before, so each component's posterior is one pass against
+    // a running forward convolution.
+    std::vector<double> w(totalSpan + 1);
+    double peak = -std::numeric_limits<double>::infinity();
+    for (int j = 0; j <= totalSpan; ++j)
+      peak = std::max(peak, logWeight(base + j));
+    if (std::isinf(peak))
+      return inconsistent();
+    for (int j = 0; j <= totalSpan; ++j)
+      w[j] = std::exp(logWeight(base + j) - peak);
+
+    std::vector<size_t> active;
+    for (size_t c = 0; c < count; ++c)
+      if (span[c] > 0)
+        active.push_back(c);
+    std::vector<int> before(active.size() + 1, 0);
+    for (size_t i = 0; i < active.size(); ++i)
+      before[i + 1] = before[i] + span[active[i]];
+
+    std::vector<std::vector<double>> backward(active.size() + 1);
+    backward[active.size()] = w;
+    for (size_t i = active.size(); i-- > 0;) {
+      const std::vector<double> &d = weights[active[i]];
+      const std::vector<double> &next = backward[i + 1];
+      std::vector<double> &table = backward[i];
+      table.assign(before[i] + 1, 0.0);
+      for (int j = 0; j <= before[i]; ++j)
+        for (size_t k = 0; k < d.size(); ++k)
+          table[j] += d[k] * next[j + k];
+      rescale(table);
+    }
+
+    std::vector<double> forward{1.0};
+    for (size_t i = 0; i < active.size(); ++i) {
+      std::vector<double> &d = weights[active[i]];
+      const std::vector<double> &next = backward[i + 1];
+      std::vector<double> posterior(d.size(), 0.0);
+      std::vector<double> convolved(forward.size() + d.size() - 1, 0.0);
+      for (size_t k = 0; k < d.size(); ++k)
+        for (size_t a = 0; a < forward.size(); ++a) {
+          posterior[k] += forward[a] * next[a + k];
+          convolved[a + k] += forward[a] * d[k];
+        }
+      for (size_t k = 0; k < d.size(); ++k)
+        d[k] *= posterior[k];
+      rescale(convolved);
+      forward.swap(convolved);
+    }
+
+    if (others > 0) {
+      double mass = 0.0, mined = 0.0;
+      for (int j = 0; j <= totalSpan; ++j) {
+        mass += forward[j] * w[j];
+        mined += forward[j] * w[j] * (minesLeft - base - j);
+      }
+      if (mass <= 0.0)
+        return inconsistent();
+      otherProbability = mined / (mass * others);
+    }
+  } else {
+    // Mean field: the ratio C(U, M-K-1) / C(U, M-K) barely moves over one
+    // component's range, so weight each component by it at the expected
+    // frontier total and iterate that expectation a few times.
+    exactResult = false;
+    std::vector<std::vector<double>> raw = weights;
+    double expected = base;
+    for (size_t c = 0; c < count; ++c) {
+      double mass = 0.0, mined = 0.0;
+      for (size_t k = 0; k < raw[c].size(); ++k) {
+        mass += raw[c][k];
+        mined += raw[c][k] * k;
+      }
+      expected += mined / mass;
+    }
+    for (int round = 0; round < 4; ++round) {
+      const double left = minesLeft - expected;
+      const double ratio = std::log(std::max(left, 0.5)) -
+                           std::log(std::max(others - left + 1.0, 0.5));
+      expected = base;
+      for (size_t c = 0; c < count; ++c) {
+        double mass = 0.0, mined = 0.0;
+        for (size_t k = 0; k < raw[c].size(); ++k) {
+          weights[c][k] = raw[c][k] * std::exp(std::min(k * ratio, 700.0));
+          mass += weights[c][k];
+          mined += weights[c][k] * k;
+        }
+        expected += mined / mass;
+      }
+    }
+    if (others > 0)
+      otherProbability =
+          std::min(std::max((minesLeft - expected) / others, 0.0), 1.0);
+  }
+
+  fillUniform(static_cast<float>(otherProbability));
+  const size_t rowBits = board.wordsPerRow() * 64;
+  for (size_t c = 0; c < count; ++c) {
+    const Component &comp = components[c];
+    const Distribution &dist = dists[c];
+    const size_t n = comp.cells.size();
+    double mass = 0.0;
+    for (double v : weights[c])
+      mass += v;
+    for (size_t i = 0; i < n; ++i) {
+      double mined = 0.0;
+      for (size_t k = 0; k < weights[c].size(); ++k) {
+        const size_t r = lo[c] - dist.fewestMines + k;
+        mined += weights[c][k] * dist.cellMines[r * n + i] / dist.solutions[r];
+      }
+      const int x = static_cast<int>(comp.cells[i] % rowBits);
+      const int y = static_cast<int>(comp.cells[i] / rowBits);
+      probs[static_cast<size_t>(y) * board.width + x] =
+          mass > 0.0 ? static_cast<float>(mined / mass) : 0.0f;
+    }
+  }
+}
@@ -0,0 +1,214 @@
+#include "Minesweeper/Replay.h"
+#include "Minesweeper/MoveJournal.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+const char kMagic[4] = {'M', 'S', 'R', 'P'};
+
+void putLE(std::vector<uint8_t> &out, uint64_t value, int bytes) {
+  for (int i = 0; i < bytes; ++i)
+    out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+uint64_t getLE(const uint8_t *in, int bytes) {
+  uint64_t value = 0;
+  for (int i = 0; i < bytes; ++i)
+    value |= uint64_t(in[i]) << (8 * i);
+  return value;
+}
+
+bool isCellOp(ReplayOp op) {
+  return op == ReplayOp::Reveal || op == ReplayOp::Flag ||
+         op == ReplayOp::Chord;
+}
+} // namespace
+
+void ReplayWriter::begin(const Board &board) {
+  header = ReplayHeader();
+  header.flags = board.safeOpening ? ReplayHeader::SafeOpening : 0;
+  header.width = board.width;
+  header.height = board.height;
+  header.mines = board.mineCount;
+  header.seed = board.seed();
+  events.clear();
+  lastTime = 0;
+  lastCell = 0;
+}
+
+void ReplayWriter::add(uint64_t timeMs, ReplayOp op, int x, int y) {
+  if (header.width == 0)
+    return;
+  timeMs = std::max(timeMs, lastTime);
+  MoveJournal::putVarint(events,
+                         (timeMs - lastTime) << 3 | static_cast<uint64_t>(op));
+  lastTime = timeMs;
+  if (isCellOp(op)) {
+    const int64_t cell = int64_t(y) * header.width + x;
+    const int64_t delta = cell - lastCell;
+    MoveJournal::putVarint(events,
+                           (uint64_t(delta) << 1) ^ uint64_t(delta >> 63));
+    lastCell = cell;
+  }
+  header.eventCount++;
+}
+
+void ReplayWriter::encode(std::vector<uint8_t> &out) const {
+  out.insert(out.end(), kMagic, kMagic + 4);
+  putLE(out, header.version, 2);
+  putLE(out, header.flags, 2);
+  putLE(out, header.width, 4);
+  putLE(out, header.height, 4);
+  putLE(out, header.mines, 4);
+  putLE(out, header.eventCount, 4);
+  putLE(out, header.seed, 8);
+  putLE(out, events.size(), 8);
+  out.insert(out.end(), events.begin(), events.end());
+}
+
+bool ReplayWriter::appendTo(const char *path) const {
+  std::vector<uint8_t> bytes;
+  encode(bytes);
+  FILE *out = std::fopen(path, "ab");
+  if (!out)
+    return false;
+  const bool ok = std::fwrite(bytes.data(), 1, bytes.size(), out) ==
+                  bytes.size();
+  return std::fclose(out) == 0 && ok;
+}
+
+bool ReplayCursor::next(ReplayEvent &event) {
+  uint64_t tag;
+  if (pos >= end || !MoveJournal::getVarint(pos, end, tag))
+    return false;
+  time += tag >> 3;
+  event.timeMs = time;
+  if ((tag & 7) > static_cast<uint64_t>(lastOp))
+    return false;
+  event.op = static_cast<ReplayOp>(tag & 7);
+  event.x = event.y = 0;
+  if (isCellOp(event.op)) {
+    uint64_t zigzag;
+    if (!MoveJournal::getVarint(pos, end, zigzag))
+      return false;
+    // wrapping add: a corrupt delta may be anywhere in 64 bits, and Board
+    // does not bounds-check, so it must stop here
+    const uint64_t delta = (zigzag >> 1) ^ (0 - (zigzag & 1));
+    cell = static_cast<int64_t>(static_cast<uint64_t>(cell) + delta);
+    if (cell < 0 || cell >= cells)
+      return false;
+    event.x = static_cast<int>(cell % width);
+    event.y = static_cast<int>(cell / width);
+  }
+  return true;
+}
+
+bool ReplayArchive::open(const char *path) {
+  close();
+  const int fd = ::open(path, O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    ::close(fd);
+    return false;
+  }
+  length = static_cast<size_t>(info.st_size);
+  if (length > 0) {
+    void *mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) {
+      ::close(fd);
+      length = 0;
+      return false;
+    }
+    madvise(mapped, length, MADV_SEQUENTIAL);
+    data = static_cast<const uint8_t *>(mapped);
+  }
+  ::close(fd); // the mapping keeps the file alive
+  offset = 0;
+  return true;
+}
+
+void ReplayArchive::close() {
+  if (data)
+    munmap(const_cast<uint8_t *>(data), length);
+  data = nullptr;
+  length = offset = 0;
+}
+
+bool ReplayArchive::next(ReplayView &view) {
+  if (length - offset < kReplayHeaderSize)
+    return false;
+  const uint8_t *p = data + offset;
+  if (std::memcmp(p, kMagic, 4) != 0)
+    return false;
+
+  ReplayHeader &h = view.header;
+  h.version = static_cast<uint16_t>(getLE(p + 4, 2));
+  h.flags = static_cast<uint16_t>(getLE(p + 6, 2));
+  h.width = static_cast<int>(getLE(p + 8, 4));
+  h.height = static_cast<int>(getLE(p + 12, 4));
+  h.mines = static_cast<int>(getLE(p + 16, 4));
+  h.eventCount = static_cast<uint32_t>(getLE(p + 20, 4));
+  h.seed = getLE(p + 24, 8);
+  h.eventBytes = getLE(p + 32, 8);
+  if (h.version < 1 || h.version > kReplayVersion || h.width <= 0 ||
+      h.height <= 0 || h.eventBytes > length - offset - kReplayHeaderSize)
+    return false;
+  // Board addresses cells with 32-bit bit indices over rows padded to whole
+  // words, which also keeps width * height from overflowing
+  const uint64_t paddedBits =
+      (static_cast<uint64_t>(h.width) + 63) / 64 * 64 * h.height;
+  if (paddedBits > (uint64_t(1) << 32) || h.mines < 0 ||
+      static_cast<int64_t>(h.mines) > int64_t(h.width) * h.height)
+    return false;
+
+  view.begin = p + kReplayHeaderSize;
+  view.end = view.begin + h.eventBytes;
+  offset += kReplayHeaderSize + h.eventBytes;
+  return true;
+}
+
+Board makeReplayBoard(const ReplayHeader &header) {
+  Board board(header.width, header.height, header.mines, header.seed);
+  board.safeOpening = header.flags & ReplayHeader::SafeOpening;
+  return board;
+}
+
+void applyReplayEvent(Board &board, const ReplayEvent &event) {
+  switch (event.op) {
+  case ReplayOp::Reveal:
+    board.reveal(event.x, event.y);
+    break;
+  case ReplayOp::Flag:
+    board.toggleFlag(event.x, event.y);
+    break;
+  case ReplayOp::Undo:
+    board.undo();
+    break;
+  case ReplayOp::Redo:
+    board.redo();
+    break;
+  case ReplayOp::RevealAllMines:
+    board.revealAllMines();
+    break;
+  case ReplayOp::Chord:
+    board.chord(event.x, event.y);
+    break;
+  }
+}
+
+size_t ReplayPlayer::advance(uint64_t timeMs) {
+  size_t applied = 0;
+  while (pending && upcoming.timeMs <= timeMs) {
+    applyReplayEvent(board, upcoming);
+    ++applied;
+    pending = cursor.next(upcoming);
+  }
+  return applied;
+}
@@ -0,0 +1,214 @@
+#include "Minesweeper/Solver.h"
+#include "Minesweeper/BitOps.h"
+#include <algorithm>
+
+namespace {
+// Constraints are compared inside a 7x7 window centred on the constraint
+// being processed: its own unknowns lie within distance 1 and those of any
+// constraint it can share a cell with lie within distance 3.
+constexpr int kFrameRadius = 3;
+constexpr int kFrameSize = 2 * kFrameRadius + 1;
+
+inline int frameBit(int fx, int fy) {
+  return (fy + kFrameRadius) * kFrameSize + (fx + kFrameRadius);
+}
+} // namespace
+
+Solver::Solver(const Board &board)
+    : board(board), knownSafe(board.wordsPerPlane()),
+      knownMine(board.wordsPerPlane()), queued(board.wordsPerPlane()) {
+  const size_t cells = static_cast<size_t>(board.width) * board.height;
+  worklist.reserve(cells);
+  safes.reserve(cells);
+  mines.reserve(cells);
+}
+
+bool Solver::isKnownSafe(int x, int y) const {
+  return testBit(knownSafe.data(), board.bitIndex(x, y));
+}
+
+bool Solver::isKnownMine(int x, int y) const {
+  return testBit(knownMine.data(), board.bitIndex(x, y));
+}
+
+void Solver::solve() {
+  clearKnowledge();
+  seedFrontier();
+  propagate();
+}
+
+void Solver::update(const std::vector<uint32_t> &changed) {
+  const size_t rowBits = board.wordsPerRow() * 64;
+  for (uint32_t bit : changed)
+    enqueueAround(static_cast<int>(bit % rowBits),
+                  static_cast<int>(bit / rowBits));
+  propagate();
+}
+
+void Solver::clearKnowledge() {
+  std::fill(knownSafe.begin(), knownSafe.end(), 0);
+  std::fill(knownMine.begin(), knownMine.end(), 0);
+  std::fill(queued.begin(), queued.end(), 0);
+  worklist.clear();
+  safes.clear();
+  mines.clear();
+}
+
+void Solver::seedFrontier() {
+  // Frontier constraints are revealed safe cells with at least one hidden
+  // neighbor: revealed & ~mine & dilate(hidden), computed a word at a time.
+  const uint64_t *revealed = board.plane(Board::RevealedPlane);
+  const uint64_t *mineBits = board.plane(Board::MinePlane);
+  const size_t rowWords = board.wordsPerRow();
+  const uint64_t tailMask = rowTailMask(board.width);
+  auto hiddenWord = [&](int y, long w) -> uint64_t {
+    if (y < 0 || y >= board.height || w < 0 || w >= long(rowWords))
+      return 0;
+    uint64_t valid = (size_t(w) + 1 == rowWords) ? tailMask : ~uint64_t(0);
+    return ~revealed[y * rowWords + w] & valid;
+  };
+
+  for (int y = 0; y < board.height; ++y) {
+    for (size_t w = 0; w < rowWords; ++w) {
+      uint64_t near = 0;
+      for (int dy = -1; dy <= 1; ++dy) {
+        uint64_t c = hiddenWord(y + dy, long(w));
+        uint64_t prev = hiddenWord(y + dy, long(w) - 1);
+        uint64_t next = hiddenWord(y + dy, long(w) + 1);
+        near |= c | (c << 1) | (prev >> 63) | (c >> 1) | (next << 63);
+      }
+      const size_t idx = y * rowWords + w;
+      uint64_t frontier = revealed[idx] & ~mineBits[idx] & near;
+      while (frontier) {
+        int x = static_cast<int>(w * 64) + countTrailingZeros64(frontier);
+        frontier &= frontier - 1;
+        setBit(queued.data(), board.bitIndex(x, y));
+        worklist.push_back(static_cast<uint32_t>(board.bitIndex(x, y)));
+      }
+    }
+  }
+}
+
+void Solver::propagate() {
+  const size_t rowBits = board.wordsPerRow() * 64;
+  while (!worklist.empty()) {
+    const uint32_t bit = worklist.back();
+    worklist.pop_back();
+    clearBit(queued.data(), bit);
+    processConstraint(static_cast<int>(bit % rowBits),
+                      static_cast<int>(bit / rowBits));
+  }
+}
+
+void Solver::enqueueAround(int x, int y) {
+  for (int dy = -1; dy <= 1; ++dy)
+    for (int dx = -1; dx <= 1; ++dx) {
+      int nx = x + dx, ny = y + dy;
+      if (nx < 0 || nx >= board.width || ny < 0 || ny >= board.height ||
+          !board.isRevealed(nx, ny) || board.isMine(nx, ny))
+        continue;
+      const size_t bit = board.bitIndex(nx, ny);
+      if (testBit(queued.data(), bit))
+        continue;
+      setBit(queued.data(), bit);
+      worklist.push_back(static_cast<uint32_t>(bit));
+    }
+}
+
+bool Solver::constraintAt(int x, int y, int originX, int originY,
+                          uint64_t &unknown, int &needed) const {
+  if (x < 0 || x >= board.width || y < 0 || y >= board.height ||
+      !board.isRevealed(x, y) || board.isMine(x, y))
+    return false;
+
+  unknown = 0;
+  needed = board.neighborCount(x, y);
+  for (int dy = -1; dy <= 1; ++dy)
+    for (int dx = -1; dx <= 1; ++dx) {
+      int nx = x + dx, ny = y + dy;
+      if ((!dx && !dy) || nx < 0 || nx >= board.width || ny < 0 ||
+          ny >= board.height || board.isRevealed(nx, ny))
+        continue;
+      const size_t bit = board.bitIndex(nx, ny);
+      if (board.isFlagged(nx, ny) || testBit(knownMine.data(), bit))
+        needed--;
+      else if (!testBit(knownSafe.data(), bit))
+        unknown |= uint64_t(1) << frameBit(nx - originX, ny - originY);
+    }
+  // flags the player got wrong can make a constraint unsatisfiable
+  return unknown && needed >= 0 && needed <= popcount64(unknown);
+}
+
+void Solver::settle(int originX, int originY, uint64_t cells, bool mine) {
+  while (cells) {
+    const int b = countTrailingZeros64(cells);
+    cells &= cells - 1;
+    const int x = originX + b % kFrameSize - kFrameRadius;
+    const int y = originY + b / kFrameSize - kFrameRadius;
+    const size_t bit = board.bitIndex(x, y);
+    if (testBit(knownSafe.data(), bit) || testBit(knownMine.data(), bit))
+      continue;
+    if (mine) {
+      setBit(knownMine.data(), bit);
+      mines.push_back(static_cast<uint32_t>(bit));
+    } else {
+      setBit(knownSafe.data(), bit);
+      safes.push_back(static_cast<uint32_t>(bit));
+    }
+    enqueueAround(x, y);
+  }
+}
+
+void Solver::processConstraint(int x, int y) {
+  uint64_t unknown;
+  int needed;
+  if (!constraintAt(x, y, x, y, unknown, needed))
+    return;
+
+  const int size = popcount64(unknown);
+  if (needed == 0) {
+    settle(x, y, unknown, false);
+    return;
+  }
+  if (needed == size) {
+    settle(x, y, unknown, true);
+    return;
+  }
+
+  for (int oy = -2; oy <= 2; ++oy)
+    for (int ox = -2; ox <= 2; ++ox) {
+      if (!ox && !oy)
+        continue;
+      uint64_t other;
+      int otherNeeded;
+      if (!constraintAt(x + ox, y + oy, x, y, other, otherNeeded) ||
+          !(other & unknown))
+        continue;
+
+      uint64_t diff;
+      int diffMines;
+      bool ownCells;
+      if ((other & ~unknown) == 0 && other != unknown) {
+        diff = unknown & ~other;
+        diffMines = needed - otherNeeded;
+        ownCells = true;
+      } else if ((unknown & ~other) == 0 && other != unknown) {
+        diff = other & ~unknown;
+        diffMines = otherNeeded - needed;
+        ownCells = false;
+      } else {
+        continue;
+      }
+
+      if (diffMines == 0)
+        settle(x, y, diff, false);
+      else if (diffMines == popcount64(diff))
+        settle(x, y, diff, true);
+      else
+        continue;
+      // settling our own cells changed this constraint and put it back on
+      // the worklist; cells outside it leave it intact, so keep scanning
+      if (ownCells)
+        return;
+    }
+}
@@ -0,0 +1,343 @@
+#include "Minesweeper/VolumeBoard.h"
+#include "Minesweeper/BitOps.h"
+#include "Minesweeper/NeighborCount.h"
+#include <algorithm>
+#include <cmath>
+
+VolumeBoard::VolumeBoard(int w, int h, int d, int mines, uint64_t seed)
+    : width(w), height(h), depth(d), mineCount(mines),
+      rowWords((static_cast<size_t>(w) + 63) / 64),
+      planeWords(rowWords * static_cast<size_t>(h) * static_cast<size_t>(d)),
+      storage(planeWords * PlaneCount) {
+  reset(seed);
+}
+
+void VolumeBoard::reset() { reset(rng.next()); }
+
+void VolumeBoard::reset(uint64_t newSeed) {
+  std::fill(storage.begin(), storage.end(), 0);
+
+  boardSeed = newSeed;
+  rng.reseed(newSeed);
+  firstMove = true;
+  const int cellCount = width * height * depth;
+  minesPlaced = std::clamp(mineCount, 0, cellCount);
+  hiddenSafe = cellCount - minesPlaced;
+  flagsPlaced = 0;
+
+  placeMines();
+  calculateNumbers();
+}
+
+void VolumeBoard::placeMines() {
+  // Floyd's sampling, as in Board::placeMines.
+  uint64_t *mines = mutablePlane(MinePlane);
+  const int cellCount = width * height * depth;
+  const bool invert = minesPlaced > cellCount / 2;
+  const int picks = invert ? cellCount - minesPlaced : minesPlaced;
+  auto bitFor = [&](int idx) {
+    return static_cast<size_t>(idx / width) * rowWords * 64 + idx % width;
+  };
+
+  for (int j = cellCount - picks; j < cellCount; ++j) {
+    int t = static_cast<int>(rng.below(static_cast<uint64_t>(j) + 1));
+    size_t bit = bitFor(t);
+    if (testBit(mines, bit))
+      bit = bitFor(j);
+    setBit(mines, bit);
+  }
+
+  if (invert) {
+    const uint64_t tailMask = rowTailMask(width);
+    for (size_t row = 0; row < planeWords; row += rowWords)
+      for (size_t w = 0; w < rowWords; ++w)
+        mines[row + w] =
+            ~mines[row + w] & (w + 1 == rowWords ? tailMask : ~uint64_t(0));
+  }
+}
+
+void VolumeBoard::calculateNumbers() {
+  uint64_t *const counts[5] = {
+      mutablePlane(CountPlane0), mutablePlane(CountPlane1),
+      mutablePlane(CountPlane2), mutablePlane(CountPlane3),
+      mutablePlane(CountPlane4)};
+  countNeighbors26BitSliced(plane(MinePlane), rowWords, width, height, depth,
+                            counts, 0, depth);
+}
+
+int VolumeBoard::countAt(size_t bit) const {
+  int count = 0;
+  for (int k = 0; k < 5; ++k)
+    count |= testBit(plane(static_cast<Plane>(CountPlane0 + k)), bit) << k;
+  return count;
+}
+
+void VolumeBoard::setCountAt(size_t bit, int count) {
+  for (int k = 0; k < 5; ++k) {
+    uint64_t *p = mutablePlane(static_cast<Plane>(CountPlane0 + k));
+    if ((count >> k) & 1)
+      setBit(p, bit);
+    else
+      clearBit(p, bit);
+  }
+}
+
+void VolumeBoard::cellAt(size_t bit, int &x, int &y, int &z) const {
+  const size_t rowBits = rowWords * 64;
+  const size_t row = bit / rowBits;
+  x = static_cast<int>(bit % rowBits);
+  y = static_cast<int>(row % height);
+  z = static_cast<int>(row / height);
+}
+
+Cell VolumeBoard::get(int x, int y, int z) const {
+  const size_t bit = bitIndex(x, y, z);
+  Cell cell;
+  cell.type = testBit(plane(MinePlane), bit) ? CellType::Mine : CellType::Empty;
+  if (testBit(plane(RevealedPlane), bit))
+    cell.state = CellState::Revealed;
+  else if (testBit(plane(FlaggedPlane), bit))
+    cell.state = CellState::Flagged;
+  cell.neighborMines = countAt(bit);
+  return cell;
+}
+
+bool VolumeBoard::isMine(int x, int y, int z) const {
+  return testBit(plane(MinePlane), bitIndex(x, y, z));
+}
+
+bool VolumeBoard::isRevealed(int x, int y, int z) const {
+  return testBit(plane(RevealedPlane), bitIndex(x, y, z));
+}
+
+bool VolumeBoard::isFlagged(int x, int y, int z) const {
+  return testBit(plane(FlaggedPlane), bitIndex(x, y, z));
+}
+
+int VolumeBoard::neighborCount(int x, int y, int z) const {
+  return countAt(bitIndex(x, y, z));
+}
+
+void VolumeBoard::toggleFlag(int x, int y, int z) {
+  const size_t bit = bitIndex(x, y, z);
+  if (testBit(plane(RevealedPlane), bit))
+    return;
+  uint64_t *flagged = mutablePlane(FlaggedPlane);
+  flagsPlaced += testBit(flagged, bit) ? -1 : 1;
+  flipBit(flagged, bit);
+}
+
+bool VolumeBoard::reveal(int x, int y, int z) {
+  revealQueue.clear();
+  const size_t bit = bitIndex(x, y, z);
+  if (testBit(plane(RevealedPlane), bit) || testBit(plane(FlaggedPlane), bit))
+    return false;
+
+  if (firstMove) {
+    firstMove = false;
+    if (testBit(plane(MinePlane), bit))
+      relocateMine(x, y, z);
+  }
+
+  uint64_t *revealed = mutablePlane(RevealedPlane);
+  setBit(revealed, bit);
+  revealQueue.push_back(static_cast<uint32_t>(bit));
+  if (testBit(plane(MinePlane), bit))
+    return true;
+
+  // Breadth-first flood fill over the 26-neighborhood; see Board::reveal.
+  // Interior cells use precomputed bit offsets and skip the bounds checks.
+  const uint64_t *flagged = plane(FlaggedPlane);
+  const ptrdiff_t rowBits = static_cast<ptrdiff_t>(rowWords * 64);
+  ptrdiff_t offsets[26];
+  int offsetCount = 0;
+  for (int dz = -1; dz <= 1; ++dz)
+    for (int dy = -1; dy <= 1; ++dy)
+      for (int dx = -1; dx <= 1; ++dx)
+        if (dx || dy || dz)
+          offsets[offsetCount++] = (dz * height + dy) * rowBits + dx;
+
+  auto visit = [&](size_t next) {
+    if (testBit(revealed, next) || testBit(flagged, next))
+      return;
+    setBit(revealed, next);
+    revealQueue.push_back(static_cast<uint32_t>(next));
+  };
+
+  for (size_t head = 0; head < revealQueue.size(); ++head) {
+    const size_t cur = revealQueue[head];
+    if (countAt(cur) != 0)
+      continue;
+
+    int cx, cy, cz;
+    cellAt(cur, cx, cy, cz);
+    if (cx > 0 && cx < width - 1 && cy > 0 && cy < height - 1 && cz > 0 &&
+        cz < depth - 1) {
+      for (ptrdiff_t offset : offsets)
+        visit(cur + offset);
+      continue;
+    }
+
+    for (int dz = -1; dz <= 1; ++dz) {
+      int nz = cz + dz;
+      if (nz < 0 || nz >= depth)
+        continue;
+      for (int dy = -1; dy <= 1; ++dy) {
+        int ny = cy + dy;
+        if (ny < 0 || ny >= height)
+          continue;
+        for (int dx = -1; dx <= 1; ++dx) {
+          int nx = cx + dx;
+          if ((!dx && !dy && !dz) || nx < 0 || nx >= width)
+            continue;
+          visit(bitIndex(nx, ny, nz));
+        }
+      }
+    }
+  }
+
+  hiddenSafe -= static_cast<int>(revealQueue.size());
+  return false;
+}
+
+void VolumeBoard::revealAllMines() {
+  const uint64_t *mines = plane(MinePlane);
+  uint64_t *revealed = mutablePlane(RevealedPlane);
+  uint64_t *flagged = mutablePlane(FlaggedPlane);
+  flagsPlaced = 0;
+  for (size_t i = 0; i < planeWords; ++i) {
+    revealed[i] |= mines[i];
+    flagged[i] &= ~mines[i];
+    flagsPlaced += popcount64(flagged[i]);
+  }
+}
+
+void VolumeBoard::relocateMine(int x, int y, int z) {
+  // Move the mine and patch only the two 3x3x3 neighborhoods it affects.
+  auto adjustNeighbors = [&](int cx, int cy, int cz, int delta) {
+    int mines = 0;
+    for (int dz = -1; dz <= 1; ++dz)
+      for (int dy = -1; dy <= 1; ++dy)
+        for (int dx = -1; dx <= 1; ++dx) {
+          int nx = cx + dx, ny = cy + dy, nz = cz + dz;
+          if ((!dx && !dy && !dz) || nx < 0 || nx >= width || ny < 0 ||
+              ny >= height || nz < 0 || nz >= depth)
+            continue;
+          size_t n = bitIndex(nx, ny, nz);
+          if (testBit(plane(MinePlane), n))
+            mines++;
+          else
+            setCountAt(n, countAt(n) + delta);
+        }
+    return mines;
+  };
+
+  const size_t from = bitIndex(x, y, z);
+  clearBit(mutablePlane(MinePlane), from);
+  setCountAt(from, adjustNeighbors(x, y, z, -1));
+
+  const int cellCount = width * height * depth;
+  size_t target = from;
+  for (int attempt = 0; attempt < 64 && target == from; ++attempt) {
+    int idx = static_cast<int>(rng.below(cellCount));
+    size_t bit = static_cast<size_t>(idx / width) * rowWords * 64 + idx % width;
+    if (bit != from && !testBit(plane(MinePlane), bit))
+      target = bit;
+  }
+  if (target == from) {
+    // nearly full volume: fall back to a word-wide scan
+    const uint64_t *mines = plane(MinePlane);
+    const size_t rowBits = rowWords * 64;
+    for (size_t i = 0; i < planeWords && target == from; ++i) {
+      uint64_t free = ~mines[i];
+      while (free) {
+        size_t bit = i * 64 + countTrailingZeros64(free);
+        free &= free - 1;
+        if (bit % rowBits < static_cast<size_t>(width) && bit != from) {
+          target = bit;
+          break;
+        }
+      }
+    }
+  }
+
+  if (target == from) {
+    --minesPlaced;
+    ++hiddenSafe;
+    return;
+  }
+  int tx, ty, tz;
+  cellAt(target, tx, ty, tz);
+  setBit(mutablePlane(MinePlane), target);
+  setCountAt(target, 0);
+  adjustNeighbors(tx, ty, tz, +1);
+}
+
+glm::vec3 VolumeBoard::cellCenter(int x, int y, int z, float spacing) const {
+  return glm::vec3((x - (width - 1) * 0.5f) * spacing,
+                   (y - (height - 1) * 0.5f) * spacing,
+                   (z - (depth - 1) * 0.5f) * spacing);
+}
+
+bool VolumeBoard::pick(const glm::vec3 &origin, const glm::vec3 &direction,
+                       float spacing, float maxDistance, int &outX, int &outY,
+                       int &outZ) const {
+  // Amanatides-Woo traversal in grid units, where cell i spans [i, i + 1).
+  const glm::ivec3 dims(width, height, depth);
+  const glm::vec3 gridMin = -glm::vec3(dims) * (spacing * 0.5f);
+  const glm::vec3 start = (origin - gridMin) / spacing;
+  const glm::vec3 dir = glm::normalize(direction);
+
+  float tEnter = 0.0f;
+  float tExit = maxDistance / spacing;
+  for (int a = 0; a < 3; ++a) {
+    if (dir[a] == 0.0f) {
+      if (start[a] < 0.0f || start[a] >= dims[a])
+        return false;
+      continue;
+    }
+    float t0 = (0.0f - start[a]) / dir[a];
+    float t1 = (dims[a] - start[a]) / dir[a];
+    tEnter = std::max(tEnter, std::min(t0, t1));
+    tExit = std::min(tExit, std::max(t0, t1));
+  }
+  if (tEnter > tExit)
+    return false;
+
+  const glm::vec3 entry = start + dir * tEnter;
+  glm::ivec3 cell = glm::clamp(glm::ivec3(glm::floor(entry)), glm::ivec3(0),
+                               dims - 1);
+  glm::ivec3 step;
+  glm::vec3 tMax, tDelta;
+  for (int a = 0; a < 3; ++a) {
+    if (dir[a] > 0.0f) {
+      step[a] = 1;
+      tDelta[a] = 1.0f / dir[a];
+      tMax[a] = tEnter + (cell[a] + 1 - entry[a]) * tDelta[a];
+    } else if (dir[a] < 0.0f) {
+      step[a] = -1;
+      tDelta[a] = -1.0f / dir[a];
+      tMax[a] = tEnter + (entry[a] - cell[a]) * tDelta[a];
+    } else {
+      step[a] = 0;
+      tDelta[a] = tMax[a] = INFINITY;
+    }
+  }
+
+  while (true) {
+    if (!isRevealed(cell.x, cell.y, cell.z)) {
+      outX = cell.x;
+      outY = cell.y;
+      outZ = cell.z;
+      return true;
+    }
+    int axis = tMax.x < tMax.y ? (tMax.x < tMax.z ? 0 : 2)
+                               : (tMax.y < tMax.z ? 1 : 2);
+    if (tMax[axis] > tExit)
+      return false;
+    cell[axis] += step[axis];
+    if (cell[axis] < 0 || cell[axis] >= dims[axis])
+      return false;
+    tMax[axis] += tDelta[axis];
+  }
+}
@@ -1,5 +1,3 @@
-#define STB_EASY_FONT_IMPLEMENTATION
-#include "stb_easy_font/stb_easy_font.h"
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
@@ -9,15 +7,23 @@
 #include "Minesweeper/Shader.h"
 #include "Minesweeper/Camera.h"
 #include "Minesweeper/Cube.h"
+#include "Minesweeper/FrameUniforms.h"
 #include "Minesweeper/Board.h"
+#include "Minesweeper/HintService.h"
+#include "Minesweeper/NoGuess.h"
+#include "Minesweeper/Picking.h"
+#include "Minesweeper/Replay.h"
 #include "Minesweeper/Skybox.h"
+#include "Minesweeper/StreamBuffer.h"
+#include "Minesweeper/TextRenderer.h"
+#include "Minesweeper/TileRenderer.h"
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <vector>
-#include <limits>
 
 // Window settings (initial only)
 const unsigned int SCR_WIDTH = 1920;
@@ -28,6 +34,8 @@ void mouse_button_callback(GLFWwindow *window, int button, int action,
 
 extern Camera camera;
 extern Board board;
+extern HintService hints;
+extern ReplayWriter replay;
 
 glm::vec3 debugRayOrigin;
 glm::vec3 debugRayDir;
@@ -37,8 +45,19 @@ bool gameWon = false;
 bool inMenu = true;
 bool enterPressedLast = false;
 bool menuPressedLast = false;
-unsigned int textVAO = 0;
-unsigned int textVBO = 0;
+bool noGuessMode = false;
+bool noGuessPressedLast = false;
+bool hintPressedLast = false;
+bool undoPressedLast = false;
+bool redoPressedLast = false;
+bool savePressedLast = false;
+bool loadPressedLast = false;
+int hintX = -1;
+int hintY = -1;
+// The 2D overlay batch and the debug ray come from one ring of per-frame
+// vertex memory.
+StreamBuffer *transientVertices = nullptr;
+unsigned int rayVAO = 0;
 
 namespace {
 struct TilePalette {
@@ -54,35 +73,117 @@ const TilePalette kFlaggedPalette{glm::vec3(0.9f, 0.34f, 0.26f),
                                   glm::vec3(0.55f, 0.14f, 0.1f)};
 const TilePalette kMinePalette{glm::vec3(0.96f, 0.28f, 0.35f),
                                glm::vec3(0.6f, 0.12f, 0.18f)};
+const TilePalette kHintPalette{glm::vec3(0.3f, 0.78f, 0.45f),
+                               glm::vec3(0.08f, 0.35f, 0.16f)};
+
+// Tile palettes by TileView::palette; palette p occupies slots 2p (face)
+// and 2p + 1 (border) of the cube shader's palette array, followed by the
+// debug ray color.
+enum PaletteId { HiddenTile, RevealedTile, FlaggedTile, MineTile, HintTile };
+const std::array<TilePalette, 5> kTilePalettes = {
+    kHiddenPalette, kRevealedPalette, kFlaggedPalette, kMinePalette,
+    kHintPalette};
+const uint32_t kRayColorSlot = 2 * kTilePalettes.size();
+static_assert(kRayColorSlot < TileRenderer::kPaletteSize,
+              "tile palettes overflow the cube shader's palette array");
 
 const std::array<glm::vec3, 8> kNumberColors = {
     glm::vec3(0.32f, 0.68f, 1.0f), glm::vec3(0.35f, 0.9f, 0.45f),
     glm::vec3(0.98f, 0.45f, 0.45f), glm::vec3(0.7f, 0.5f, 0.98f),
     glm::vec3(0.98f, 0.72f, 0.4f), glm::vec3(0.45f, 0.9f, 0.9f),
     glm::vec3(0.95f, 0.88f, 0.45f), glm::vec3(0.96f, 0.96f, 0.96f)};
+
+// Per-cell render state, rebuilt only for the cells the board reports as
+// changed since the last frame. Cell i owns tile instances 2i (border) and
+// 2i + 1 (face).
+struct TileView {
+  PaletteId palette;
+  bool hidden;
+  std::string label;
+  glm::vec3 labelColor;
+};
+
+std::vector<TileView> tileViews;
+uint64_t tileViewsSynced = 0;
+size_t shownHint = SIZE_MAX;
+
+void writeTileInstances(TileRenderer &tiles, int x, int y, PaletteId palette) {
+  const size_t cell = static_cast<size_t>(y) * board.width + x;
+  const glm::vec3 center = gridCenter(x, y, board);
+  tiles.instance(2 * cell) = {center, 1.04f, 0.6f, 2u * palette + 1};
+  tiles.instance(2 * cell + 1) = {center, 0.92f, 0.35f, 2u * palette};
+}
+
+void updateTileView(TileRenderer &tiles, int x, int y) {
+  TileView &tile = tileViews[static_cast<size_t>(y) * board.width + x];
+  const Cell cell = board.get(x, y);
+  tile.hidden = cell.state == CellState::Hidden;
+  tile.palette = HiddenTile;
+  tile.label.clear();
+  if (cell.state == CellState::Revealed) {
+    if (cell.type == CellType::Mine) {
+      tile.palette = MineTile;
+      tile.label = "B";
+      tile.labelColor = glm::vec3(1.0f, 0.3f, 0.3f);
+    } else {
+      tile.palette = RevealedTile;
+      if (cell.neighborMines > 0) {
+        tile.label = std::to_string(cell.neighborMines);
+        tile.labelColor = kNumberColors[std::min(cell.neighborMines, 8) - 1];
+      }
+    }
+  } else if (cell.state == CellState::Flagged) {
+    tile.palette = FlaggedTile;
+    tile.label = "F";
+    tile.labelColor = glm::vec3(1.0f, 0.85f, 0.2f);
+  }
+  writeTileInstances(tiles, x, y, tile.palette);
+}
+
+void syncTileViews(TileRenderer &tiles) {
+  const size_t rowBits = board.wordsPerRow() * 64;
+  const size_t cells = static_cast<size_t>(board.width) * board.height;
+  const bool incremental =
+      tileViews.size() == cells &&
+      board.changesSince(tileViewsSynced, [&](uint32_t bit) {
+        updateTileView(tiles, static_cast<int>(bit % rowBits),
+                       static_cast<int>(bit / rowBits));
+      });
+  if (!incremental) {
+    tileViews.resize(cells);
+    tiles.resize(2 * cells);
+    for (int y = 0; y < board.height; ++y)
+      for (int x = 0; x < board.width; ++x)
+        updateTileView(tiles, x, y);
+    shownHint = SIZE_MAX;
+  }
+  tileViewsSynced = board.changeGeneration();
+
+  // the hint recolors a hidden tile without changing the board
+  const size_t hint =
+      hintX >= 0 ? static_cast<size_t>(hintY) * board.width + hintX : SIZE_MAX;
+  if (hint == shownHint)
+    return;
+  if (shownHint != SIZE_MAX)
+    writeTileInstances(tiles, static_cast<int>(shownHint % board.width),
+                       static_cast<int>(shownHint / board.width),
+                       tileViews[shownHint].palette);
+  shownHint = SIZE_MAX;
+  if (hint != SIZE_MAX && tileViews[hint].hidden) {
+    writeTileInstances(tiles, hintX, hintY, HintTile);
+    shownHint = hint;
+  }
+}
 } // namespace
 
 void startNewGame(GLFWwindow *window);
+void saveReplay();
+void loadGame(GLFWwindow *window);
+uint64_t replayTime();
 void updateCursorMode(GLFWwindow *window);
 bool worldToScreen(const glm::vec3 &world, const glm::mat4 &view,
                    const glm::mat4 &projection, int fbW, int fbH,
                    glm::vec2 &screen);
-void drawText(Shader &shader, const std::string &text, float x, float y,
-              float scale, const glm::vec3 &color, int fbW, int fbH);
-void drawCenteredText(Shader &shader, const std::string &text, float centerX,
-                      float centerY, float scale, const glm::vec3 &color,
-                      int fbW, int fbH);
-
-struct TextMesh {
-  std::vector<float> vertices;
-  float width = 0.0f;
-  float height = 0.0f;
-};
-
-bool buildTextMesh(const std::string &text, float scale, TextMesh &outMesh);
-void renderTextMesh(Shader &shader, const TextMesh &mesh,
-                    const glm::vec3 &color, int fbW, int fbH);
-
 static glm::mat4 makePerspectiveFromFramebuffer(GLFWwindow *w) {
   int fbW = 0, fbH = 0;
   glfwGetFramebufferSize(w, &fbW, &fbH);
@@ -90,38 +191,26 @@ static glm::mat4 makePerspectiveFromFramebuffer(GLFWwindow *w) {
   return glm::perspective(glm::radians(45.0f), aspect, 0.1f, 100.0f);
 }
 
-static inline glm::vec3 gridCenter(int x, int y, const Board &b) {
-  // Center grid precisely: use (dim-1)/2.0f, not integer dim/2
-  const float spacing = 1.05f;
-  float gx = (x - (b.width - 1) * 0.5f) * spacing;
-  float gy = (y - (b.height - 1) * 0.5f) * spacing;
-  return glm::vec3(gx, gy, 0.0f);
-}
-
-void drawRay(const glm::vec3 &origin, const glm::vec3 &direction,
-             Shader &shader) {
-  shader.setMat4("model", glm::mat4(1.0f)); // draw in world space
+// Draws with the cube shader; the per-instance attributes it does not
+// supply take constant values: no offset, unit scale, the ray color.
+void drawRay(const glm::vec3 &origin, const glm::vec3 &direction) {
+  glVertexAttrib3f(1, 0.0f, 1.0f, 0.0f);
+  glVertexAttrib4f(2, 0.0f, 0.0f, 0.0f, 1.0f);
+  glVertexAttrib1f(3, 0.0f);
+  glVertexAttribI1ui(4, kRayColorSlot);
 
   float length = 100.0f;
   glm::vec3 end = origin + direction * length;
 
   float vertices[] = {origin.x, origin.y, origin.z, end.x, end.y, end.z};
+  GLint first = 0;
+  if (!transientVertices->write(vertices, sizeof(vertices), 3 * sizeof(float),
+                                first))
+    return;
 
-  unsigned int VAO = 0, VBO = 0;
-  glGenVertexArrays(1, &VAO);
-  glGenBuffers(1, &VBO);
-
-  glBindVertexArray(VAO);
-  glBindBuffer(GL_ARRAY_BUFFER, VBO);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)0);
-  glEnableVertexAttribArray(0);
-
-  glDrawArrays(GL_LINES, 0, 2);
-
-  glDeleteBuffers(1, &VBO);
-  glDeleteVertexArrays(1, &VAO);
+  glBindVertexArray(rayVAO);
+  glDrawArrays(GL_LINES, first, 2);
+  glBindVertexArray(0);
 }
 
 void mouse_button_callback(GLFWwindow *window, int button, int action,
@@ -166,58 +255,47 @@ void mouse_button_callback(GLFWwindow *window, int button, int action,
 
   // --- Ray-AABB picking ---
   int hitX = -1, hitY = -1;
-  float minDist = 1e9f;
   const float maxClickDistance = 100.0f;
-
-  for (int x = 0; x < board.width; ++x) {
-    for (int y = 0; y < board.height; ++y) {
-      glm::vec3 c = gridCenter(x, y, board);
-      glm::vec3 minB = c - glm::vec3(0.5f);
-      glm::vec3 maxB = c + glm::vec3(0.5f);
-
-      float invDirX = (rayWorld.x != 0.0f) ? 1.0f / rayWorld.x : 1e6f;
-      float invDirY = (rayWorld.y != 0.0f) ? 1.0f / rayWorld.y : 1e6f;
-      float invDirZ = (rayWorld.z != 0.0f) ? 1.0f / rayWorld.z : 1e6f;
-
-      float t1 = (minB.x - rayOrigin.x) * invDirX;
-      float t2 = (maxB.x - rayOrigin.x) * invDirX;
-      float t3 = (minB.y - rayOrigin.y) * invDirY;
-      float t4 = (maxB.y - rayOrigin.y) * invDirY;
-      float t5 = (minB.z - rayOrigin.z) * invDirZ;
-      float t6 = (maxB.z - rayOrigin.z) * invDirZ;
-
-      float tmin =
-          std::max({std::min(t1, t2), std::min(t3, t4), std::min(t5, t6)});
-      float tmax =
-          std::min({std::max(t1, t2), std::max(t3, t4), std::max(t5, t6)});
-
-      if (tmax >= std::max(0.0f, tmin) && tmin < minDist &&
-          tmin < maxClickDistance) {
-        minDist = tmin;
-        hitX = x;
-        hitY = y;
-      }
-    }
-  }
+  pickTile(board, rayOrigin, rayWorld, maxClickDistance, hitX, hitY);
 
   if (hitX >= 0 && hitY >= 0) {
     if (button == GLFW_MOUSE_BUTTON_LEFT) {
-      bool hitMine = board.reveal(hitX, hitY);
+      if (noGuessMode && board.isFirstMove() &&
+          generateNoGuess(board, hitX, hitY)) {
+        hints.onReset();
+        replay.begin(board); // regenerating discarded any earlier flags
+      }
+      // clicking an uncovered number chords it
+      bool hitMine;
+      if (board.isRevealed(hitX, hitY)) {
+        hitMine = board.chord(hitX, hitY);
+        replay.chord(replayTime(), hitX, hitY);
+      } else {
+        hitMine = board.reveal(hitX, hitY);
+        replay.reveal(replayTime(), hitX, hitY);
+      }
+      hints.onReveal();
+      hintX = hintY = -1;
       if (hitMine) {
         gameOver = true;
         gameWon = false;
         inMenu = false;
         board.revealAllMines();
+        replay.revealAllMines(replayTime());
         updateCursorMode(window);
       } else if (board.checkWin()) {
         gameOver = true;
         gameWon = true;
         inMenu = false;
         board.revealAllMines();
+        replay.revealAllMines(replayTime());
         updateCursorMode(window);
       }
     } else if (button == GLFW_MOUSE_BUTTON_RIGHT) {
       board.toggleFlag(hitX, hitY);
+      replay.toggleFlag(replayTime(), hitX, hitY);
+      hints.onToggleFlag(hitX, hitY);
+      hintX = hintY = -1;
     }
   }
 
@@ -236,6 +314,11 @@ void mouse_button_callback(GLFWwindow *window, int button, int action,
 // Camera setup
 Camera camera(glm::vec3(0.0f, 0.0f, 15.0f));
 Board board(12, 12, 28); // larger board for denser gameplay
+HintService hints(board);
+ReplayWriter replay;
+double replayStart = 0.0;
+const char *const kReplayPath = "replays.msr";
+const char *const kSnapshotPath = "quicksave.mss";
 float lastX = SCR_WIDTH / 2.0f;
 float lastY = SCR_HEIGHT / 2.0f;
 bool firstMouse = true;
@@ -293,28 +376,29 @@ int main() {
 
   cubeShader.use();
   cubeShader.setInt("skyboxMap", 0);
+  {
+    std::array<glm::vec3, TileRenderer::kPaletteSize> palette{};
+    for (size_t p = 0; p < kTilePalettes.size(); ++p) {
+      palette[2 * p] = kTilePalettes[p].face;
+      palette[2 * p + 1] = kTilePalettes[p].border;
+    }
+    palette[kRayColorSlot] = glm::vec3(1.0f, 0.0f, 0.0f);
+    cubeShader.setVec3Array("palette", palette.data(), kRayColorSlot + 1);
+  }
   skyboxShader.use();
   skyboxShader.setInt("skyboxMap", 0);
 
-  // Text rendering setup
-  glGenVertexArrays(1, &textVAO);
-  glGenBuffers(1, &textVBO);
-  glBindVertexArray(textVAO);
-  glBindBuffer(GL_ARRAY_BUFFER, textVBO);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 2, nullptr, GL_DYNAMIC_DRAW);
-  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void *)0);
-  glEnableVertexAttribArray(0);
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-  glBindVertexArray(0);
+  // Camera, time and sky rotation reach every program through one buffer
+  FrameUniforms frameUniforms;
 
-  unsigned int crosshairVAO = 0;
-  unsigned int crosshairVBO = 0;
-  glGenVertexArrays(1, &crosshairVAO);
-  glGenBuffers(1, &crosshairVBO);
-  glBindVertexArray(crosshairVAO);
-  glBindBuffer(GL_ARRAY_BUFFER, crosshairVBO);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 48, nullptr, GL_DYNAMIC_DRAW);
-  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void *)0);
+  // Transient geometry: the 2D overlay batch and the ray
+  StreamBuffer streamVertices(1 << 20);
+  transientVertices = &streamVertices;
+  TextRenderer overlay(streamVertices, textShader);
+  glGenVertexArrays(1, &rayVAO);
+  glBindVertexArray(rayVAO);
+  glBindBuffer(GL_ARRAY_BUFFER, streamVertices.buffer());
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)0);
   glEnableVertexAttribArray(0);
   glBindBuffer(GL_ARRAY_BUFFER, 0);
   glBindVertexArray(0);
@@ -347,6 +431,7 @@ int main() {
 
   // Cube object
   Cube cube;
+  TileRenderer tiles(cube);
   Skybox skybox;
 
   // Game/render loop
@@ -358,6 +443,7 @@ int main() {
     lastFrame = currentFrame;
 
     processInput(window);
+    streamVertices.beginFrame();
 
     int fbW = 0, fbH = 0;
     glfwGetFramebufferSize(window, &fbW, &fbH);
@@ -365,23 +451,20 @@ int main() {
     glClearColor(0.05f, 0.07f, 0.1f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    glm::mat4 projection = makePerspectiveFromFramebuffer(window);
+    glm::mat4 view = camera.GetViewMatrix();
+    frameUniforms.update(projection, view, camera.Position, currentFrame);
+
     glDisable(GL_DEPTH_TEST);
     backgroundShader.use();
-    backgroundShader.setFloat("time", currentFrame);
     glBindVertexArray(backgroundVAO);
     glDrawArrays(GL_TRIANGLES, 0, 6);
     glBindVertexArray(0);
     glEnable(GL_DEPTH_TEST);
 
-    glm::mat4 projection = makePerspectiveFromFramebuffer(window);
-    glm::mat4 view = camera.GetViewMatrix();
-
     glDepthMask(GL_FALSE);
     glDepthFunc(GL_LEQUAL);
     skyboxShader.use();
-    skyboxShader.setMat4("projection", projection);
-    skyboxShader.setMat4("view", glm::mat4(glm::mat3(view)));
-    skyboxShader.setFloat("time", currentFrame);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_CUBE_MAP, skybox.texture());
     skybox.Draw();
@@ -389,49 +472,14 @@ int main() {
     glDepthMask(GL_TRUE);
 
     cubeShader.use();
-    cubeShader.setMat4("projection", projection);
-    cubeShader.setMat4("view", view);
-    cubeShader.setVec3("cameraPos", camera.Position);
-    cubeShader.setFloat("time", currentFrame);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_CUBE_MAP, skybox.texture());
 
-    for (int x = 0; x < board.width; ++x) {
-      for (int y = 0; y < board.height; ++y) {
-        const Cell &cell = board.get(x, y);
-
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, gridCenter(x, y, board));
-
-        TilePalette palette = kHiddenPalette;
-        if (cell.state == CellState::Revealed) {
-          if (cell.type == CellType::Mine) {
-            palette = kMinePalette;
-          } else {
-            palette = kRevealedPalette;
-          }
-        } else if (cell.state == CellState::Flagged) {
-          palette = kFlaggedPalette;
-        }
-
-        glm::mat4 borderModel = glm::scale(model, glm::vec3(1.04f));
-        glm::mat4 tileModel = glm::scale(model, glm::vec3(0.92f));
-
-        cubeShader.setMat4("model", borderModel);
-        cubeShader.setVec3("color", palette.border);
-        cubeShader.setFloat("reflectivity", 0.6f);
-        cube.Draw();
-
-        cubeShader.setMat4("model", tileModel);
-        cubeShader.setVec3("color", palette.face);
-        cubeShader.setFloat("reflectivity", 0.35f);
-        cube.Draw();
-      }
-    }
+    syncTileViews(tiles);
+    tiles.Draw();
 
     if (drawDebugRay) {
-      cubeShader.setVec3("color", glm::vec3(1.0f, 0.0f, 0.0f));
-      drawRay(debugRayOrigin, debugRayDir, cubeShader);
+      drawRay(debugRayOrigin, debugRayDir);
     }
 
     glDisable(GL_DEPTH_TEST);
@@ -454,99 +502,80 @@ int main() {
       float bottomStart = centerY - gap - armLength;
       float bottomEnd = centerY - gap;
 
-      std::array<float, 48> crosshairVertices = {
-          // Left arm
-          leftStart, centerY - halfThickness, leftEnd, centerY - halfThickness,
-          leftEnd, centerY + halfThickness, leftStart, centerY - halfThickness,
-          leftEnd, centerY + halfThickness, leftStart, centerY + halfThickness,
-          // Right arm
-          rightStart, centerY - halfThickness, rightEnd, centerY - halfThickness,
-          rightEnd, centerY + halfThickness, rightStart, centerY - halfThickness,
-          rightEnd, centerY + halfThickness, rightStart, centerY + halfThickness,
-          // Top arm
-          centerX - halfThickness, topStart, centerX + halfThickness, topStart,
-          centerX + halfThickness, topEnd, centerX - halfThickness, topStart,
-          centerX + halfThickness, topEnd, centerX - halfThickness, topEnd,
-          // Bottom arm
-          centerX - halfThickness, bottomStart, centerX + halfThickness,
-          bottomStart, centerX + halfThickness, bottomEnd,
-          centerX - halfThickness, bottomStart, centerX + halfThickness,
-          bottomEnd, centerX - halfThickness, bottomEnd};
-
-      textShader.use();
-      textShader.setVec3("textColor", glm::vec3(0.92f, 0.96f, 1.0f));
-      glm::mat4 ortho = glm::ortho(0.0f, (float)fbW, 0.0f, (float)fbH);
-      textShader.setMat4("projection", ortho);
-
-      glBindVertexArray(crosshairVAO);
-      glBindBuffer(GL_ARRAY_BUFFER, crosshairVBO);
-      glBufferSubData(GL_ARRAY_BUFFER, 0,
-                      crosshairVertices.size() * sizeof(float),
-                      crosshairVertices.data());
-      glDrawArrays(GL_TRIANGLES, 0, 24);
-      glBindBuffer(GL_ARRAY_BUFFER, 0);
-      glBindVertexArray(0);
+      // each arm is a rectangle of two triangles
+      std::array<glm::vec2, 24> crosshairVertices;
+      auto arm = [&](int i, float x0, float y0, float x1, float y1) {
+        const glm::vec2 corners[6] = {{x0, y0}, {x1, y0}, {x1, y1},
+                                      {x0, y0}, {x1, y1}, {x0, y1}};
+        std::copy(corners, corners + 6, crosshairVertices.begin() + 6 * i);
+      };
+      arm(0, leftStart, centerY - halfThickness, leftEnd,
+          centerY + halfThickness);
+      arm(1, rightStart, centerY - halfThickness, rightEnd,
+          centerY + halfThickness);
+      arm(2, centerX - halfThickness, topStart, centerX + halfThickness,
+          topEnd);
+      arm(3, centerX - halfThickness, bottomStart, centerX + halfThickness,
+          bottomEnd);
+      overlay.addTriangles(crosshairVertices.data(), crosshairVertices.size(),
+                           glm::vec3(0.92f, 0.96f, 1.0f));
     }
 
+    const TextRenderer::Anchor center = TextRenderer::Anchor::Center;
     float cellTextScale = 4.2f * resolutionScale;
     for (int x = 0; x < board.width; ++x) {
       for (int y = 0; y < board.height; ++y) {
-        const Cell &cell = board.get(x, y);
+        const TileView &tile =
+            tileViews[static_cast<size_t>(y) * board.width + x];
         glm::vec2 screenPos;
-        if (!worldToScreen(gridCenter(x, y, board), view, projection, fbW, fbH,
+        if (tile.label.empty() ||
+            !worldToScreen(gridCenter(x, y, board), view, projection, fbW, fbH,
                            screenPos))
           continue;
-
-        if (cell.state == CellState::Revealed) {
-          if (cell.type == CellType::Mine) {
-            drawCenteredText(textShader, "B", screenPos.x, screenPos.y,
-                             cellTextScale, glm::vec3(1.0f, 0.3f, 0.3f), fbW,
-                             fbH);
-          } else if (cell.neighborMines > 0) {
-            std::string numberText = std::to_string(cell.neighborMines);
-            glm::vec3 numberColor =
-                kNumberColors[std::min(cell.neighborMines, 8) - 1];
-            drawCenteredText(textShader, numberText, screenPos.x, screenPos.y,
-                             cellTextScale, numberColor, fbW, fbH);
-          }
-        } else if (cell.state == CellState::Flagged) {
-          drawCenteredText(textShader, "F", screenPos.x, screenPos.y,
-                           cellTextScale, glm::vec3(1.0f, 0.85f, 0.2f), fbW,
-                           fbH);
-        }
+        overlay.addText(tile.label, screenPos.x, screenPos.y, cellTextScale,
+                        tile.labelColor, center);
       }
     }
 
     float overlayScale = 3.6f * resolutionScale;
     if (inMenu) {
-      drawCenteredText(textShader, "3D Minesweeper", fbW * 0.5f,
-                       fbH * 0.75f, overlayScale * 1.3f, glm::vec3(0.9f), fbW,
-                       fbH);
-      drawCenteredText(textShader,
-                       "Left Click: Reveal   Right Click: Flag", fbW * 0.5f,
-                       fbH * 0.6f, overlayScale * 0.6f,
-                       glm::vec3(0.8f, 0.8f, 0.8f), fbW, fbH);
-      drawCenteredText(textShader, "Press Enter to start", fbW * 0.5f,
-                       fbH * 0.45f, overlayScale * 0.8f,
-                       glm::vec3(0.6f, 0.8f, 1.0f), fbW, fbH);
+      overlay.addText("3D Minesweeper", fbW * 0.5f, fbH * 0.75f,
+                      overlayScale * 1.3f, glm::vec3(0.9f), center);
+      overlay.addText("Left Click: Reveal/Chord   Right Click: Flag   "
+                      "H: Hint   Z/Y: Undo/Redo   F5/F9: Save/Load",
+                      fbW * 0.5f, fbH * 0.6f, overlayScale * 0.6f,
+                      glm::vec3(0.8f, 0.8f, 0.8f), center);
+      overlay.addText("Press Enter to start", fbW * 0.5f, fbH * 0.45f,
+                      overlayScale * 0.8f, glm::vec3(0.6f, 0.8f, 1.0f),
+                      center);
+      overlay.addText(noGuessMode ? "No-guess mode: ON (G)"
+                                  : "No-guess mode: OFF (G)",
+                      fbW * 0.5f, fbH * 0.35f, overlayScale * 0.5f,
+                      glm::vec3(0.8f, 0.8f, 0.8f), center);
     } else if (gameOver) {
       const char *resultText =
           gameWon ? "You cleared the field!" : "Boom! You hit a mine.";
-      drawCenteredText(textShader, resultText, fbW * 0.5f, fbH * 0.6f,
-                       overlayScale, glm::vec3(0.95f), fbW, fbH);
-      drawCenteredText(textShader, "Press Enter to play again", fbW * 0.5f,
-                       fbH * 0.45f, overlayScale * 0.7f,
-                       glm::vec3(0.6f, 0.8f, 1.0f), fbW, fbH);
+      overlay.addText(resultText, fbW * 0.5f, fbH * 0.6f, overlayScale,
+                      glm::vec3(0.95f), center);
+      overlay.addText("Press Enter to play again", fbW * 0.5f, fbH * 0.45f,
+                      overlayScale * 0.7f, glm::vec3(0.6f, 0.8f, 1.0f),
+                      center);
     } else {
-      drawText(textShader, "Press M to toggle menu", 20.0f, fbH - 40.0f,
-               overlayScale * 0.4f, glm::vec3(0.8f, 0.8f, 0.8f), fbW, fbH);
+      overlay.addText("Press M to toggle menu", 20.0f, fbH - 40.0f,
+                      overlayScale * 0.4f, glm::vec3(0.8f, 0.8f, 0.8f));
+      overlay.addText("Mines left: " + std::to_string(board.minesRemaining()),
+                      20.0f, fbH - 70.0f, overlayScale * 0.4f,
+                      glm::vec3(1.0f, 0.85f, 0.2f));
     }
 
+    overlay.Draw(fbW, fbH);
     glEnable(GL_DEPTH_TEST);
 
+    streamVertices.endFrame();
     glfwSwapBuffers(window);
   }
 
+  saveReplay();
   glfwTerminate();
   return 0;
 }
@@ -594,6 +623,71 @@ void processInput(GLFWwindow *window) {
     }
   }
   menuPressedLast = (menuState == GLFW_PRESS);
+
+  int noGuessState = glfwGetKey(window, GLFW_KEY_G);
+  if (noGuessState == GLFW_PRESS && !noGuessPressedLast && inMenu)
+    noGuessMode = !noGuessMode;
+  noGuessPressedLast = (noGuessState == GLFW_PRESS);
+
+  int hintState = glfwGetKey(window, GLFW_KEY_H);
+  if (hintState == GLFW_PRESS && !hintPressedLast && !inMenu && !gameOver) {
+    if (!hints.nextSafe(hintX, hintY))
+      hintX = hintY = -1;
+  }
+  hintPressedLast = (hintState == GLFW_PRESS);
+
+  // A finished game also journaled revealAllMines(), so undo steps back over
+  // it and the final move together, and redo replays both.
+  int undoState = glfwGetKey(window, GLFW_KEY_Z);
+  if (undoState == GLFW_PRESS && !undoPressedLast && !inMenu) {
+    if (gameOver) {
+      board.undo();
+      replay.undo(replayTime());
+    }
+    const bool undone = board.undo();
+    replay.undo(replayTime());
+    if (undone) {
+      hints.onReset();
+      hintX = hintY = -1;
+      if (gameOver) {
+        gameOver = false;
+        gameWon = false;
+        firstMouse = true;
+        updateCursorMode(window);
+      }
+    }
+  }
+  undoPressedLast = (undoState == GLFW_PRESS);
+
+  int redoState = glfwGetKey(window, GLFW_KEY_Y);
+  if (redoState == GLFW_PRESS && !redoPressedLast && !inMenu && !gameOver) {
+    const bool redone = board.redo();
+    replay.redo(replayTime());
+    if (redone) {
+      hints.onReset();
+      hintX = hintY = -1;
+      if (board.checkWin() || board.mineRevealed()) {
+        gameOver = true;
+        gameWon = board.checkWin();
+        board.redo();
+        replay.redo(replayTime());
+        updateCursorMode(window);
+      }
+    }
+  }
+  redoPressedLast = (redoState == GLFW_PRESS);
+
+  int saveState = glfwGetKey(window, GLFW_KEY_F5);
+  if (saveState == GLFW_PRESS && !savePressedLast && !inMenu && !gameOver) {
+    if (!board.saveSnapshot(kSnapshotPath))
+      std::cerr << "Failed to save snapshot to " << kSnapshotPath << "\n";
+  }
+  savePressedLast = (saveState == GLFW_PRESS);
+
+  int loadState = glfwGetKey(window, GLFW_KEY_F9);
+  if (loadState == GLFW_PRESS && !loadPressedLast)
+    loadGame(window);
+  loadPressedLast = (loadState == GLFW_PRESS);
 }
 
 void mouse_callback(GLFWwindow * /*window*/, double xpos, double ypos) {
@@ -615,7 +709,13 @@ void mouse_callback(GLFWwindow * /*window*/, double xpos, double ypos) {
 }
 
 void startNewGame(GLFWwindow *window) {
+  saveReplay();
+  board.safeOpening = noGuessMode;
   board.reset();
+  replay.begin(board);
+  replayStart = glfwGetTime();
+  hints.onReset();
+  hintX = hintY = -1;
   gameOver = false;
   gameWon = false;
   inMenu = false;
@@ -624,6 +724,38 @@ void startNewGame(GLFWwindow *window) {
   updateCursorMode(window);
 }
 
+// Resumes the quicksave. A loaded game cannot be rebuilt from its seed, so
+// it is not recorded as a replay.
+void loadGame(GLFWwindow *window) {
+  Board loaded(1, 1, 0, 0);
+  if (!loaded.loadSnapshot(kSnapshotPath) || loaded.width != board.width ||
+      loaded.height != board.height) {
+    std::cerr << "Failed to load snapshot from " << kSnapshotPath << "\n";
+    return;
+  }
+  saveReplay();
+  board = std::move(loaded);
+  hints.onReset();
+  hintX = hintY = -1;
+  gameWon = board.checkWin();
+  gameOver = gameWon || board.mineRevealed();
+  inMenu = false;
+  drawDebugRay = false;
+  firstMouse = true;
+  updateCursorMode(window);
+}
+
+// Every game played is appended to the replay archive once it is left.
+void saveReplay() {
+  if (replay.eventCount() && !replay.appendTo(kReplayPath))
+    std::cerr << "Failed to save replay to " << kReplayPath << "\n";
+  replay = ReplayWriter();
+}
+
+uint64_t replayTime() {
+  return static_cast<uint64_t>((glfwGetTime() - replayStart) * 1000.0);
+}
+
 void updateCursorMode(GLFWwindow *window) {
   if (!window)
     return;
@@ -649,128 +781,3 @@ bool worldToScreen(const glm::vec3 &world, const glm::mat4 &view,
   screen.y = (ndc.y * 0.5f + 0.5f) * (float)fbH;
   return true;
 }
-
-bool buildTextMesh(const std::string &text, float scale, TextMesh &outMesh) {
-  if (text.empty() || scale <= 0.0f)
-    return false;
-
-  stb_easy_font_spacing(0.0f);
-
-  char buffer[99999];
-  int numQuads =
-      stb_easy_font_print(0.0f, 0.0f, const_cast<char *>(text.c_str()), nullptr,
-                          buffer, sizeof(buffer));
-  if (numQuads <= 0)
-    return false;
-
-  struct EasyFontVertex {
-    float x, y;
-    unsigned char color[4];
-    unsigned char padding[4];
-  };
-
-  auto *quadVertices = reinterpret_cast<EasyFontVertex *>(buffer);
-
-  float minX = std::numeric_limits<float>::max();
-  float maxX = std::numeric_limits<float>::lowest();
-  float minY = std::numeric_limits<float>::max();
-  float maxY = std::numeric_limits<float>::lowest();
-
-  for (int i = 0; i < numQuads * 4; ++i) {
-    const EasyFontVertex &v = quadVertices[i];
-    minX = std::min(minX, v.x);
-    maxX = std::max(maxX, v.x);
-    minY = std::min(minY, v.y);
-    maxY = std::max(maxY, v.y);
-  }
-
-  float widthUnits = std::max(0.0f, maxX - minX);
-  float heightUnits = std::max(0.0f, maxY - minY);
-  if (widthUnits <= 0.0f)
-    widthUnits = static_cast<float>(
-        stb_easy_font_width(const_cast<char *>(text.c_str())));
-  if (heightUnits <= 0.0f)
-    heightUnits = static_cast<float>(
-        stb_easy_font_height(const_cast<char *>(text.c_str())));
-  outMesh.width = widthUnits * scale;
-  outMesh.height = heightUnits * scale;
-
-  outMesh.vertices.clear();
-  outMesh.vertices.reserve(numQuads * 6 * 2);
-
-  auto appendVertex = [&](const EasyFontVertex &v) {
-    float localX = (v.x - minX) * scale;
-    float localY = (maxY - v.y) * scale;
-    outMesh.vertices.push_back(localX);
-    outMesh.vertices.push_back(localY);
-  };
-
-  for (int i = 0; i < numQuads; ++i) {
-    const EasyFontVertex &v0 = quadVertices[i * 4 + 0];
-    const EasyFontVertex &v1 = quadVertices[i * 4 + 1];
-    const EasyFontVertex &v2 = quadVertices[i * 4 + 2];
-    const EasyFontVertex &v3 = quadVertices[i * 4 + 3];
-
-    appendVertex(v0);
-    appendVertex(v1);
-    appendVertex(v2);
-    appendVertex(v0);
-    appendVertex(v2);
-    appendVertex(v3);
-  }
-
-  return !outMesh.vertices.empty();
-}
-
-void renderTextMesh(Shader &shader, const TextMesh &mesh,
-                    const glm::vec3 &color, int fbW, int fbH) {
-  if (mesh.vertices.empty() || textVAO == 0 || textVBO == 0)
-    return;
-
-  shader.use();
-  shader.setVec3("textColor", color);
-  glm::mat4 ortho = glm::ortho(0.0f, (float)fbW, 0.0f, (float)fbH);
-  shader.setMat4("projection", ortho);
-
-  glBindVertexArray(textVAO);
-  glBindBuffer(GL_ARRAY_BUFFER, textVBO);
-  glBufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof(float),
-               mesh.vertices.data(), GL_DYNAMIC_DRAW);
-  glDrawArrays(GL_TRIANGLES, 0, (GLsizei)(mesh.vertices.size() / 2));
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-  glBindVertexArray(0);
-}
-
-void drawText(Shader &shader, const std::string &text, float x, float y,
-              float scale, const glm::vec3 &color, int fbW, int fbH) {
-  TextMesh mesh;
-  if (!buildTextMesh(text, scale, mesh))
-    return;
-
-  float posX = x;
-  float posY = y - mesh.height;
-  for (size_t i = 0; i < mesh.vertices.size(); i += 2) {
-    mesh.vertices[i] += posX;
-    mesh.vertices[i + 1] += posY;
-  }
-
-  renderTextMesh(shader, mesh, color, fbW, fbH);
-}
-
-void drawCenteredText(Shader &shader, const std::string &text, float centerX,
-                      float centerY, float scale, const glm::vec3 &color,
-                      int fbW, int fbH) {
-  TextMesh mesh;
-  if (!buildTextMesh(text, scale, mesh))
-    return;
-
-  float posX = centerX - mesh.width * 0.5f;
-  float posY = centerY - mesh.height * 0.5f;
-
-  for (size_t i = 0; i < mesh.vertices.size(); i += 2) {
-    mesh.vertices[i] += posX;
-    mesh.vertices[i + 1] += posY;
-  }
-
-  renderTextMesh(shader, mesh, color, fbW, fbH);
-}
@@ -71,6 +71,6 @@ void Cube::setupCube() {
 
 void Cube::Draw() const {
   glBindVertexArray(VAO);
-  glDrawArrays(GL_TRIANGLES, 0, 36);
+  glDrawArrays(GL_TRIANGLES, 0, kVertexCount);
   glBindVertexArray(0);
 }
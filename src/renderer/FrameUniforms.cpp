@@ -0,0 +1,59 @@
+#include "Minesweeper/FrameUniforms.h"
+#include <cmath>
+#include <cstddef>
+
+static_assert(offsetof(FrameData, cameraPos) == 256 &&
+                  offsetof(FrameData, time) == 272,
+              "FrameData must follow the std140 layout of the Frame block");
+
+namespace {
+// Same element order as GLSL mat3 constructors: column by column.
+glm::mat3 rotationX(float angle) {
+  float c = std::cos(angle), s = std::sin(angle);
+  return glm::mat3(1.0f, 0.0f, 0.0f, 0.0f, c, -s, 0.0f, s, c);
+}
+
+glm::mat3 rotationY(float angle) {
+  float c = std::cos(angle), s = std::sin(angle);
+  return glm::mat3(c, 0.0f, s, 0.0f, 1.0f, 0.0f, -s, 0.0f, c);
+}
+
+glm::mat3 rotationZ(float angle) {
+  float c = std::cos(angle), s = std::sin(angle);
+  return glm::mat3(c, -s, 0.0f, s, c, 0.0f, 0.0f, 0.0f, 1.0f);
+}
+} // namespace
+
+glm::mat3 skyRotation(float time) {
+  float yaw = time * 0.045f;
+  float pitch = std::sin(time * 0.18f) * 0.12f;
+  float roll = std::cos(time * 0.11f) * 0.05f;
+  return rotationY(yaw) * rotationX(pitch) * rotationZ(roll);
+}
+
+FrameUniforms::FrameUniforms() {
+  glGenBuffers(1, &UBO);
+  glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+  glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), nullptr,
+               GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  glBindBufferBase(GL_UNIFORM_BUFFER, kBinding, UBO);
+}
+
+FrameUniforms::~FrameUniforms() { glDeleteBuffers(1, &UBO); }
+
+void FrameUniforms::update(const glm::mat4 &projection, const glm::mat4 &view,
+                           const glm::vec3 &cameraPos, float time) {
+  FrameData data;
+  data.projection = projection;
+  data.view = view;
+  data.skyView = glm::mat4(glm::mat3(view));
+  data.skyRotation = glm::mat4(skyRotation(time));
+  data.cameraPos = glm::vec4(cameraPos, 1.0f);
+  data.time = time;
+  data.pad[0] = data.pad[1] = data.pad[2] = 0.0f;
+
+  glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameData), &data);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
@@ -1,5 +1,6 @@
 #include "Minesweeper/Shader.h"
 #include <glad/glad.h>
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -58,27 +59,67 @@ Shader::Shader(const char *vertexPath, const char *fragmentPath) {
     glGetProgramInfoLog(ID, 512, NULL, infoLog);
     std::cerr << "ERROR: Shader program linking failed:\n"
               << infoLog << std::endl;
+  } else {
+    reflectUniforms();
   }
 
   glDeleteShader(vertex);
   glDeleteShader(fragment);
 }
 
+void Shader::reflectUniforms() {
+  GLint count = 0, maxLength = 0;
+  glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+  glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+  std::vector<char> name(std::max(maxLength, 1));
+  for (GLint i = 0; i < count; ++i) {
+    GLsizei length = 0;
+    UniformInfo info;
+    glGetActiveUniform(ID, static_cast<GLuint>(i), maxLength, &length,
+                       &info.size, &info.type, name.data());
+    info.name.assign(name.data(), length);
+    // block members have no location of their own
+    info.location = glGetUniformLocation(ID, info.name.c_str());
+    if (info.location < 0)
+      continue;
+    if (info.name.size() > 3 &&
+        info.name.compare(info.name.size() - 3, 3, "[0]") == 0)
+      info.name.resize(info.name.size() - 3);
+    uniformTable.push_back(std::move(info));
+  }
+  std::sort(uniformTable.begin(), uniformTable.end(),
+            [](const UniformInfo &a, const UniformInfo &b) {
+              return a.name < b.name;
+            });
+}
+
+GLint Shader::uniformLocation(const std::string &name) const {
+  auto it = std::lower_bound(uniformTable.begin(), uniformTable.end(), name,
+                             [](const UniformInfo &info,
+                                const std::string &key) {
+                               return info.name < key;
+                             });
+  return it != uniformTable.end() && it->name == name ? it->location : -1;
+}
+
 void Shader::use() const { glUseProgram(ID); }
 
 void Shader::setBool(const std::string &name, bool value) const {
-  glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+  glUniform1i(uniformLocation(name), (int)value);
 }
 void Shader::setInt(const std::string &name, int value) const {
-  glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+  glUniform1i(uniformLocation(name), value);
 }
 void Shader::setFloat(const std::string &name, float value) const {
-  glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+  glUniform1f(uniformLocation(name), value);
 }
 void Shader::setVec3(const std::string &name, const glm::vec3 &value) const {
-  glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+  glUniform3fv(uniformLocation(name), 1, &value[0]);
+}
+void Shader::setVec3Array(const std::string &name, const glm::vec3 *values,
+                          int count) const {
+  glUniform3fv(uniformLocation(name), count, &values[0][0]);
 }
 void Shader::setMat4(const std::string &name, const glm::mat4 &mat) const {
-  glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE,
-                     &mat[0][0]);
+  glUniformMatrix4fv(uniformLocation(name), 1, GL_FALSE, &mat[0][0]);
 }
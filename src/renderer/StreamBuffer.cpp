@@ -0,0 +1,90 @@
+#include "Minesweeper/StreamBuffer.h"
+#include <cstring>
+
+StreamBuffer::StreamBuffer(size_t bytesPerFrame) : frameBytes(bytesPerFrame) {
+  glGenBuffers(1, &VBO);
+  glBindBuffer(GL_ARRAY_BUFFER, VBO);
+  if (GLAD_GL_VERSION_4_4) {
+    const GLbitfield flags =
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(GL_ARRAY_BUFFER, kFrames * frameBytes, nullptr, flags);
+    mapped = static_cast<char *>(
+        glMapBufferRange(GL_ARRAY_BUFFER, 0, kFrames * frameBytes, flags));
+  }
+  if (!mapped)
+    glBufferData(GL_ARRAY_BUFFER, frameBytes, nullptr, GL_STREAM_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+StreamBuffer::~StreamBuffer() {
+  for (GLsync fence : fences)
+    if (fence)
+      glDeleteSync(fence);
+  if (mapped) {
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+  }
+  glDeleteBuffers(1, &VBO);
+}
+
+void StreamBuffer::beginFrame() {
+  used = 0;
+  if (!persistent()) {
+    // orphan: the driver hands out fresh storage while draws in flight
+    // keep reading the old one
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, frameBytes, nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return;
+  }
+  GLsync &fence = fences[frame];
+  if (!fence)
+    return;
+  GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+  while (true) {
+    const GLenum status = glClientWaitSync(fence, waitFlags, 1000000);
+    if (status != GL_TIMEOUT_EXPIRED)
+      break;
+    waitFlags = 0;
+  }
+  glDeleteSync(fence);
+  fence = nullptr;
+}
+
+void StreamBuffer::endFrame() {
+  if (persistent()) {
+    fences[frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    frame = (frame + 1) % kFrames;
+  }
+}
+
+size_t StreamBuffer::alignedOffset(size_t stride) const {
+  // align the absolute offset so it lands on a whole vertex
+  return ((regionBase() + used + stride - 1) / stride) * stride;
+}
+
+size_t StreamBuffer::available(size_t stride) const {
+  const size_t base = regionBase();
+  const size_t offset = alignedOffset(stride);
+  return offset < base + frameBytes ? (base + frameBytes - offset) / stride
+                                    : 0;
+}
+
+bool StreamBuffer::write(const void *data, size_t bytes, size_t stride,
+                         GLint &firstVertex) {
+  const size_t base = regionBase();
+  const size_t offset = alignedOffset(stride);
+  if (offset + bytes > base + frameBytes)
+    return false;
+  if (persistent()) {
+    std::memcpy(mapped + offset, data, bytes);
+  } else {
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferSubData(GL_ARRAY_BUFFER, offset, bytes, data);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+  }
+  used = offset + bytes - base;
+  firstVertex = static_cast<GLint>(offset / stride);
+  return true;
+}
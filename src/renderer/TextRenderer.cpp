@@ -0,0 +1,131 @@
+#define STB_EASY_FONT_IMPLEMENTATION
+#include "stb_easy_font/stb_easy_font.h"
+#include "Minesweeper/TextRenderer.h"
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+// stb_easy_font emits quads of four of these.
+struct EasyFontVertex {
+  float x, y;
+  unsigned char color[4];
+  unsigned char padding[4];
+};
+
+// The busiest printable glyph ('X') takes 11 quads.
+constexpr size_t kBytesPerChar = 12 * 4 * sizeof(EasyFontVertex);
+
+uint32_t packColor(const glm::vec3 &color) {
+  const glm::vec3 c = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+  return static_cast<uint32_t>(c.r) | static_cast<uint32_t>(c.g) << 8 |
+         static_cast<uint32_t>(c.b) << 16 | 0xffu << 24;
+}
+} // namespace
+
+TextRenderer::TextRenderer(StreamBuffer &stream, const Shader &shader)
+    : stream(stream), shader(shader),
+      projection(shader.uniform<glm::mat4>("projection")) {
+  stb_easy_font_spacing(0.0f);
+
+  glGenVertexArrays(1, &VAO);
+  glBindVertexArray(VAO);
+  glBindBuffer(GL_ARRAY_BUFFER, stream.buffer());
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                        (void *)offsetof(Vertex, position));
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex),
+                        (void *)offsetof(Vertex, color));
+  glEnableVertexAttribArray(1);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindVertexArray(0);
+}
+
+TextRenderer::~TextRenderer() { glDeleteVertexArrays(1, &VAO); }
+
+const TextRenderer::Layout &TextRenderer::layout(const std::string &text) {
+  auto it = layouts.find(text);
+  if (it != layouts.end())
+    return it->second;
+  if (layouts.size() >= kMaxLayouts)
+    layouts.clear();
+
+  Layout &out = layouts[text];
+  scratch.resize(text.size() * kBytesPerChar);
+  char *str = const_cast<char *>(text.c_str());
+  const int numQuads =
+      stb_easy_font_print(0.0f, 0.0f, str, nullptr, scratch.data(),
+                          static_cast<int>(scratch.size()));
+  if (numQuads <= 0) {
+    out.size = glm::vec2(0.0f);
+    return out;
+  }
+
+  const auto *quads = reinterpret_cast<const EasyFontVertex *>(scratch.data());
+  float minX = std::numeric_limits<float>::max();
+  float maxX = std::numeric_limits<float>::lowest();
+  float minY = std::numeric_limits<float>::max();
+  float maxY = std::numeric_limits<float>::lowest();
+  for (int i = 0; i < numQuads * 4; ++i) {
+    minX = std::min(minX, quads[i].x);
+    maxX = std::max(maxX, quads[i].x);
+    minY = std::min(minY, quads[i].y);
+    maxY = std::max(maxY, quads[i].y);
+  }
+  out.size.x = maxX > minX ? maxX - minX
+                           : static_cast<float>(stb_easy_font_width(str));
+  out.size.y = maxY > minY ? maxY - minY
+                           : static_cast<float>(stb_easy_font_height(str));
+
+  // stb_easy_font's y grows downwards; flip it so the string sits on y = 0
+  out.triangles.reserve(numQuads * 6);
+  auto local = [&](const EasyFontVertex &v) {
+    return glm::vec2(v.x - minX, maxY - v.y);
+  };
+  for (int i = 0; i < numQuads; ++i) {
+    const EasyFontVertex *q = quads + i * 4;
+    for (int corner : {0, 1, 2, 0, 2, 3})
+      out.triangles.push_back(local(q[corner]));
+  }
+  return out;
+}
+
+void TextRenderer::addText(const std::string &text, float x, float y,
+                           float scale, const glm::vec3 &color,
+                           Anchor anchor) {
+  if (text.empty() || scale <= 0.0f)
+    return;
+  const Layout &glyphs = layout(text);
+  const glm::vec2 size = glyphs.size * scale;
+  const glm::vec2 origin = anchor == Anchor::Center
+                               ? glm::vec2(x, y) - size * 0.5f
+                               : glm::vec2(x, y - size.y);
+  const uint32_t packed = packColor(color);
+  for (const glm::vec2 &p : glyphs.triangles)
+    vertices.push_back({origin + p * scale, packed});
+}
+
+void TextRenderer::addTriangles(const glm::vec2 *points, size_t count,
+                                const glm::vec3 &color) {
+  const uint32_t packed = packColor(color);
+  for (size_t i = 0; i < count; ++i)
+    vertices.push_back({points[i], packed});
+}
+
+void TextRenderer::Draw(int fbW, int fbH) {
+  // whatever does not fit in the frame's stream region is dropped
+  const size_t count =
+      std::min(vertices.size(), stream.available(sizeof(Vertex)));
+  GLint first = 0;
+  if (count &&
+      stream.write(vertices.data(), count * sizeof(Vertex), sizeof(Vertex),
+                   first)) {
+    shader.use();
+    projection.set(glm::ortho(0.0f, (float)fbW, 0.0f, (float)fbH));
+    glBindVertexArray(VAO);
+    glDrawArrays(GL_TRIANGLES, first, static_cast<GLsizei>(count));
+    glBindVertexArray(0);
+  }
+  vertices.clear();
+}
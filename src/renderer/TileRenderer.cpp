@@ -0,0 +1,64 @@
+#include "Minesweeper/TileRenderer.h"
+#include <cstddef>
+
+TileRenderer::TileRenderer(const Cube &cube) {
+  glGenVertexArrays(1, &VAO);
+  glGenBuffers(1, &instanceVBO);
+  glBindVertexArray(VAO);
+
+  glBindBuffer(GL_ARRAY_BUFFER, cube.vertexBuffer());
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *)0);
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float),
+                        (void *)(3 * sizeof(float)));
+  glEnableVertexAttribArray(1);
+
+  // position and scale share one vec4 attribute
+  glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+  glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(TileInstance),
+                        (void *)offsetof(TileInstance, position));
+  glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(TileInstance),
+                        (void *)offsetof(TileInstance, reflectivity));
+  glVertexAttribIPointer(4, 1, GL_UNSIGNED_INT, sizeof(TileInstance),
+                         (void *)offsetof(TileInstance, palette));
+  for (GLuint attrib = 2; attrib <= 4; ++attrib) {
+    glEnableVertexAttribArray(attrib);
+    glVertexAttribDivisor(attrib, 1);
+  }
+
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindVertexArray(0);
+}
+
+TileRenderer::~TileRenderer() {
+  glDeleteVertexArrays(1, &VAO);
+  glDeleteBuffers(1, &instanceVBO);
+}
+
+void TileRenderer::resize(size_t count) {
+  instances.assign(count, TileInstance{glm::vec3(0.0f), 0.0f, 0.0f, 0});
+  glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+  glBufferData(GL_ARRAY_BUFFER, count * sizeof(TileInstance), nullptr,
+               GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  dirtyBegin = 0;
+  dirtyEnd = count;
+}
+
+void TileRenderer::Draw() {
+  if (instances.empty())
+    return;
+  if (dirtyBegin < dirtyEnd) {
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, dirtyBegin * sizeof(TileInstance),
+                    (dirtyEnd - dirtyBegin) * sizeof(TileInstance),
+                    instances.data() + dirtyBegin);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    dirtyBegin = instances.size();
+    dirtyEnd = 0;
+  }
+  glBindVertexArray(VAO);
+  glDrawArraysInstanced(GL_TRIANGLES, 0, Cube::kVertexCount,
+                        static_cast<GLsizei>(instances.size()));
+  glBindVertexArray(0);
+}
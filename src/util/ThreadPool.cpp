@@ -0,0 +1,92 @@
+#include "Minesweeper/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+ThreadPool::ThreadPool(unsigned threads) {
+  threads = std::max(threads, 1u);
+  workers.reserve(threads);
+  for (unsigned i = 0; i < threads; ++i)
+    workers.emplace_back([this] { workerLoop(); });
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (std::thread &worker : workers)
+    worker.join();
+}
+
+ThreadPool &ThreadPool::shared() {
+  static ThreadPool pool;
+  return pool;
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    tasks.push_back(std::move(task));
+  }
+  wake.notify_one();
+}
+
+void ThreadPool::workerLoop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      wake.wait(lock, [this] { return stopping || !tasks.empty(); });
+      if (stopping && tasks.empty())
+        return;
+      task = std::move(tasks.front());
+      tasks.pop_front();
+    }
+    task();
+  }
+}
+
+void ThreadPool::parallelFor(size_t count,
+                             const std::function<void(size_t)> &body) {
+  if (count == 0)
+    return;
+  if (count == 1) {
+    body(0);
+    return;
+  }
+
+  // Items are claimed from a shared counter; helpers that start late find it
+  // exhausted and exit, so the state must outlive this call.
+  struct Shared {
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> finished{0};
+    size_t count = 0;
+    std::function<void(size_t)> body;
+    std::mutex mutex;
+    std::condition_variable done;
+  };
+  auto state = std::make_shared<Shared>();
+  state->count = count;
+  state->body = body;
+
+  auto drain = [state] {
+    size_t i;
+    while ((i = state->next.fetch_add(1)) < state->count) {
+      state->body(i);
+      if (state->finished.fetch_add(1) + 1 == state->count) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->done.notify_all();
+      }
+    }
+  };
+
+  const size_t helpers = std::min<size_t>(workers.size(), count - 1);
+  for (size_t i = 0; i < helpers; ++i)
+    submit(drain);
+  drain();
+
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->done.wait(lock, [&] { return state->finished.load() == count; });
+}
@@ -0,0 +1,128 @@
+// Regression checks for Board's change stream: a consumer synced to one
+// board must never read another board's generations as "nothing changed".
+// Build and run with `make check`.
+
+#include "Minesweeper/Board.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+int failures = 0;
+
+void expect(bool condition, const char *what) {
+  if (!condition) {
+    std::fprintf(stderr, "FAILED: %s\n", what);
+    failures++;
+  }
+}
+
+bool upToDate(const Board &board, uint64_t synced) {
+  bool any = false;
+  return board.changesSince(synced, [&](uint32_t) { any = true; }) && !any;
+}
+
+// Mirrors the game loop: reset, sync, load a snapshot into a temporary
+// board and move it over the live one.
+void loadOverSyncedBoard(const std::string &path) {
+  Board saved(16, 16, 40, 7);
+  saved.reveal(8, 8);
+  expect(saved.saveSnapshot(path.c_str()), "snapshot saved");
+
+  Board board(16, 16, 40, 1);
+  board.reset(2);
+  const uint64_t synced = board.changeGeneration();
+
+  Board loaded(16, 16, 40, 3);
+  expect(loaded.loadSnapshot(path.c_str()), "snapshot loaded");
+  board = std::move(loaded);
+  expect(!upToDate(board, synced), "moved-in snapshot forces a resync");
+}
+
+void copyDiverges() {
+  Board board(16, 16, 40, 4);
+  const uint64_t synced = board.changeGeneration();
+  Board copy = board;
+  copy.toggleFlag(0, 0);
+  board.toggleFlag(1, 1);
+  expect(!upToDate(copy, synced), "copy forces a resync");
+
+  Board assigned(9, 9, 10, 5);
+  const uint64_t assignedSynced = assigned.changeGeneration();
+  assigned = board;
+  expect(!upToDate(assigned, assignedSynced), "assignment forces a resync");
+}
+
+void incrementalStillWorks() {
+  Board board(16, 16, 40, 6);
+  const uint64_t synced = board.changeGeneration();
+  board.toggleFlag(3, 4);
+  int changes = 0;
+  expect(board.changesSince(synced, [&](uint32_t bit) {
+    changes += bit == board.bitIndex(3, 4);
+  }) && changes == 1,
+         "flag reported incrementally");
+}
+
+bool sameCell(const Board &a, const Board &b, int x, int y) {
+  return a.isMine(x, y) == b.isMine(x, y) &&
+         a.isRevealed(x, y) == b.isRevealed(x, y) &&
+         a.isFlagged(x, y) == b.isFlagged(x, y) &&
+         a.neighborCount(x, y) == b.neighborCount(x, y);
+}
+
+// Catches `before` up with `board` through the change stream alone: true
+// when the stream stayed incremental and named every cell that differs.
+bool streamCovers(const Board &before, const Board &board, uint64_t synced) {
+  std::vector<bool> logged(board.wordsPerRow() * 64 * board.height);
+  if (!board.changesSince(synced, [&](uint32_t bit) { logged[bit] = true; }))
+    return false;
+  for (int y = 0; y < board.height; ++y)
+    for (int x = 0; x < board.width; ++x)
+      if (!logged[board.bitIndex(x, y)] && !sameCell(before, board, x, y))
+        return false;
+  return true;
+}
+
+// The first reveal moves mines out of the opening; consumers should only
+// hear about the cells around them, in both directions of undo.
+void relocationStaysIncremental() {
+  Board board(32, 32, 400, 8);
+  Board before = board;
+  uint64_t synced = board.changeGeneration();
+  board.reveal(16, 16);
+  bool moved = false;
+  for (int y = 15; y <= 17; ++y)
+    for (int x = 15; x <= 17; ++x)
+      moved |= before.isMine(x, y);
+  expect(moved, "first reveal relocates a mine");
+  expect(streamCovers(before, board, synced), "relocation logged in place");
+
+  before = board;
+  synced = board.changeGeneration();
+  board.undo();
+  expect(streamCovers(before, board, synced), "undone relocation logged");
+
+  before = board;
+  synced = board.changeGeneration();
+  board.redo();
+  expect(streamCovers(before, board, synced), "redone relocation logged");
+}
+} // namespace
+
+int main() {
+  const std::string path =
+      std::string(std::getenv("TMPDIR") ? std::getenv("TMPDIR") : "/tmp") +
+      "/minesweeper_change_stream.mss";
+  loadOverSyncedBoard(path);
+  copyDiverges();
+  incrementalStillWorks();
+  relocationStaysIncremental();
+  std::remove(path.c_str());
+  if (failures)
+    return 1;
+  std::printf("change stream: ok\n");
+  return 0;
+}
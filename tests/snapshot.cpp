@@ -0,0 +1,88 @@
+// Regression checks for board snapshots: saving over a file that a board
+// still maps must not pull the pages out from under it, and headers whose
+// counters do not fit the board are refused.
+// Build and run with `make check`.
+
+#include "Minesweeper/Board.h"
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+namespace {
+int failures = 0;
+
+void expect(bool condition, const char *what) {
+  if (!condition) {
+    std::fprintf(stderr, "FAILED: %s\n", what);
+    failures++;
+  }
+}
+
+bool sameCells(const Board &a, const Board &b) {
+  if (a.width != b.width || a.height != b.height)
+    return false;
+  for (int y = 0; y < a.height; ++y)
+    for (int x = 0; x < a.width; ++x)
+      if (a.isMine(x, y) != b.isMine(x, y) ||
+          a.isRevealed(x, y) != b.isRevealed(x, y))
+        return false;
+  return true;
+}
+
+// Quick-load then quick-save to the same slot, as F9 followed by F5 does.
+void saveOverMappedFile(const std::string &path) {
+  Board board(512, 512, 40000, 11);
+  board.reveal(256, 256);
+  expect(board.saveSnapshot(path.c_str()), "snapshot saved");
+
+  Board loaded(9, 9, 10, 1);
+  expect(loaded.loadSnapshot(path.c_str()), "snapshot loaded");
+  expect(loaded.saveSnapshot(path.c_str()), "snapshot saved over its file");
+  expect(sameCells(loaded, board), "mapped pages survive the save");
+
+  Board reloaded(9, 9, 10, 1);
+  expect(reloaded.loadSnapshot(path.c_str()), "saved snapshot loads");
+  expect(sameCells(reloaded, board), "saved snapshot matches the board");
+}
+
+// Overwrites the 32-bit header field at `offset` and tries to load it.
+bool loadsWithField(const std::string &path, long offset, int32_t value) {
+  Board board(30, 16, 99, 12);
+  board.reveal(15, 8);
+  board.saveSnapshot(path.c_str());
+  FILE *file = std::fopen(path.c_str(), "r+b");
+  if (!file)
+    return false;
+  std::fseek(file, offset, SEEK_SET);
+  std::fwrite(&value, sizeof(value), 1, file);
+  std::fclose(file);
+  Board loaded(9, 9, 10, 1);
+  return loaded.loadSnapshot(path.c_str());
+}
+
+void rejectBadCounters(const std::string &path) {
+  // header offsets: mineCount 16, hiddenSafe 24, flagsPlaced 28,
+  // minesPlaced 32
+  expect(loadsWithField(path, 16, 99), "untouched header loads");
+  expect(!loadsWithField(path, 16, -1), "negative mine count refused");
+  expect(!loadsWithField(path, 16, 481), "mine count over cells refused");
+  expect(!loadsWithField(path, 24, 400), "hidden safe cells over room");
+  expect(!loadsWithField(path, 28, -5), "negative flag count refused");
+  expect(!loadsWithField(path, 32, 1 << 30), "placed mines over cells");
+}
+} // namespace
+
+int main() {
+  const std::string path =
+      std::string(std::getenv("TMPDIR") ? std::getenv("TMPDIR") : "/tmp") +
+      "/minesweeper_snapshot.mss";
+  saveOverMappedFile(path);
+  rejectBadCounters(path);
+  std::remove(path.c_str());
+  if (failures)
+    return 1;
+  std::printf("snapshot: ok\n");
+  return 0;
+}